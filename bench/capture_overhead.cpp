@@ -0,0 +1,144 @@
+#include <GL/glew.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cppplot/capture.h>
+#include <cppplot/offscreen.h>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Renders a line plot offscreen at 1200x800 and compares the frame time without readback, with the
+// PBO ring capture and with a blocking glReadPixels every frame.
+
+#ifndef CPPPLOT_HAS_EGL
+#error "capture_overhead needs EGL for offscreen rendering"
+#endif
+
+const int width = 1200;
+const int height = 800;
+const int lineNum = 100;
+const int lineSize = 2000;
+const int frames = 120;
+
+std::chrono::high_resolution_clock timer;
+
+GLuint compileProgram()
+{
+    const char *vertexShaderSource = R"(
+        #version 330 core
+        layout (location = 0) in vec2 aPos;
+        uniform float uShift;
+        void main()
+        {
+            gl_Position = vec4(aPos.x, fract(aPos.y + uShift) * 2.0 - 1.0, 0.0, 1.0);
+        }
+    )";
+    const char *fragmentShaderSource = R"(
+        #version 330 core
+        out vec4 FragColor;
+        void main()
+        {
+            FragColor = vec4(0.2, 0.7, 0.9, 1.0);
+        }
+    )";
+
+    const auto vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertexShader, 1, &vertexShaderSource, nullptr);
+    glCompileShader(vertexShader);
+    const auto fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragmentShader, 1, &fragmentShaderSource, nullptr);
+    glCompileShader(fragmentShader);
+
+    const auto program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    glLinkProgram(program);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+    return program;
+}
+
+template <typename AfterDraw>
+double msPerFrame(GLint shiftUniform, AfterDraw afterDraw)
+{
+    glFinish();
+    const auto start = timer.now();
+    for (int f = 0; f < frames; f++)
+    {
+        glClear(GL_COLOR_BUFFER_BIT);
+        glUniform1f(shiftUniform, f * 0.01f);
+        for (int i = 0; i < lineNum; i++)
+        {
+            glDrawArrays(GL_LINE_STRIP, i * lineSize, lineSize);
+        }
+        afterDraw();
+        glFlush();
+    }
+    glFinish();
+    return std::chrono::duration<double, std::milli>(timer.now() - start).count() / frames;
+}
+
+int main()
+{
+    cppplot::OffscreenContext context;
+    glewExperimental = GL_TRUE;
+    glewInit();
+    std::cout << "GL: " << glGetString(GL_RENDERER) << std::endl;
+
+    cppplot::Framebuffer framebuffer(width, height);
+    framebuffer.bind();
+
+    std::vector<float> vertices(lineNum * lineSize * 2);
+    for (int i = 0; i < lineNum; i++)
+    {
+        for (int j = 0; j < lineSize; j++)
+        {
+            vertices[(i * lineSize + j) * 2] = 2.0f * j / lineSize - 1.0f;
+            vertices[(i * lineSize + j) * 2 + 1] = (float)i / lineNum + 0.05f * std::sin(j * 0.01f);
+        }
+    }
+
+    GLuint vao;
+    GLuint vbo;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, (void *)0);
+
+    const auto program = compileProgram();
+    glUseProgram(program);
+    const auto shiftUniform = glGetUniformLocation(program, "uShift");
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+
+    // warm up the driver before timing
+    msPerFrame(shiftUniform, [] {});
+    const double baseline = msPerFrame(shiftUniform, [] {});
+
+    std::atomic<uint64_t> delivered{0};
+    double async = 0;
+    size_t dropped = 0;
+    {
+        cppplot::FrameCapture capture(width, height, [&delivered](const cppplot::CapturedFrame &)
+                                      { delivered++; });
+        async = msPerFrame(shiftUniform, [&]
+                           { capture.capture(framebuffer.id()); });
+        capture.finish();
+        dropped = capture.dropped();
+    }
+
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+    const double blocking = msPerFrame(shiftUniform, [&]
+                                       { glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data()); });
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "no capture        " << baseline << " ms/frame" << std::endl;
+    std::cout << "PBO ring capture  " << async << " ms/frame (+" << 100 * (async / baseline - 1) << "%), "
+              << delivered << " delivered, " << dropped << " dropped" << std::endl;
+    std::cout << "glReadPixels      " << blocking << " ms/frame (+" << 100 * (blocking / baseline - 1) << "%)"
+              << std::endl;
+}
@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cppplot/csv_reader.h>
+#include <cppplot/synth.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Loading a large CSV log of a time column and 7 noisy sines: CsvReader on 1 thread and every hardware
+// thread, giving the throughput and the time until the first block could be plotted, against a plain
+// getline and strtof loop. Values are written with std::to_chars, which round-trips exactly, so every
+// parsed value is checked against the generated one. The file is read once before timing to be in the
+// page cache.
+//
+//   csv_reader [size MB] [path]
+
+const size_t channels = 8;
+const size_t blockRows = 1 << 16;
+
+std::chrono::high_resolution_clock timer;
+
+double ms(std::chrono::high_resolution_clock::duration d)
+{
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+// Value of column c in row i
+struct Columns
+{
+    const cppplot::Synth synth{1};
+    std::vector<std::vector<float>> values = std::vector<std::vector<float>>(channels, std::vector<float>(blockRows));
+    size_t first = 0;
+
+    Columns()
+    {
+        generate(0);
+    }
+
+    void generate(size_t row)
+    {
+        first = row / blockRows * blockRows;
+        for (size_t i = 0; i < blockRows; i++)
+        {
+            values[0][i] = static_cast<float>(first + i) * 1e-3f;
+        }
+        for (size_t c = 1; c < channels; c++)
+        {
+            synth.sine(values[c].data(), blockRows, 1e-4f * c, 0.0f, 100.0f, 2.0f, c, first);
+        }
+    }
+
+    float operator()(size_t row, size_t c)
+    {
+        if (row < first || row >= first + blockRows)
+        {
+            generate(row);
+        }
+        return values[c][row - first];
+    }
+};
+
+int main(int argc, char **argv)
+{
+    const size_t megabytes = argc > 1 ? std::max(1, std::atoi(argv[1])) : 256;
+    const std::string path = argc > 2 ? argv[2] : "csv_reader_bench.csv";
+
+    size_t rows = 0;
+    size_t fileBytes = 0;
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "time";
+        for (size_t c = 1; c < channels; c++)
+        {
+            out << ",ch" << c;
+        }
+        out << "\n";
+        Columns columns;
+        std::vector<char> line(channels * 32);
+        while (fileBytes < megabytes * 1024 * 1024)
+        {
+            char *p = line.data();
+            for (size_t c = 0; c < channels; c++)
+            {
+                p = std::to_chars(p, line.data() + line.size(), columns(rows, c)).ptr;
+                *p++ = c + 1 < channels ? ',' : '\n';
+            }
+            out.write(line.data(), p - line.data());
+            fileBytes += p - line.data();
+            rows++;
+        }
+        if (!out)
+        {
+            std::cerr << "Could not write " << path << std::endl;
+            return 1;
+        }
+    }
+    std::cout << path << ": " << fileBytes / (1024 * 1024) << " MB, " << channels << " columns, " << rows << " rows"
+              << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+
+    // into the page cache
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::vector<char> buffer(1 << 20);
+        while (in.read(buffer.data(), buffer.size()))
+        {
+        }
+    }
+
+    bool same = true;
+    for (const size_t threads : {size_t(1), cppplot::hardwareThreads()})
+    {
+        cppplot::CsvOptions options;
+        options.threads = threads;
+        cppplot::CsvReader reader(options);
+        Columns columns;
+        size_t mismatches = 0;
+        double firstBlockMs = -1;
+        double checkMs = 0;
+
+        const auto start = timer.now();
+        const size_t parsed = reader.read(path, [&](const cppplot::CsvBlock &block)
+                                          {
+                                              const auto checkStart = timer.now();
+                                              if (firstBlockMs < 0)
+                                              {
+                                                  firstBlockMs = ms(checkStart - start);
+                                              }
+                                              for (size_t c = 0; c < channels; c++)
+                                              {
+                                                  for (size_t i = 0; i < block.rows; i++)
+                                                  {
+                                                      mismatches += block.columns[c][i] != columns(block.firstRow + i, c);
+                                                  }
+                                              }
+                                              checkMs += ms(timer.now() - checkStart);
+                                          });
+        const double totalMs = ms(timer.now() - start) - checkMs;
+        same = same && parsed == rows && mismatches == 0 && reader.columnCount() == channels && reader.names()[1] == "ch1";
+
+        std::cout << "CsvReader " << std::setw(2) << threads << " threads: " << std::setw(8) << totalMs << " ms, "
+                  << fileBytes / (totalMs * 1e6) << " GB/s, first block after " << firstBlockMs << " ms, "
+                  << mismatches << " mismatches" << std::endl;
+    }
+
+    // the usual loop, one line and one field at a time
+    {
+        const auto start = timer.now();
+        std::ifstream in(path);
+        std::string line;
+        std::getline(in, line);
+        std::vector<std::vector<float>> values(channels);
+        while (std::getline(in, line))
+        {
+            const char *p = line.c_str();
+            for (size_t c = 0; c < channels; c++)
+            {
+                char *end;
+                values[c].push_back(std::strtof(p, &end));
+                p = *end ? end + 1 : end;
+            }
+        }
+        const double totalMs = ms(timer.now() - start);
+        same = same && values[0].size() == rows;
+        std::cout << "getline and strtof:   " << std::setw(8) << totalMs << " ms, " << fileBytes / (totalMs * 1e6)
+                  << " GB/s" << std::endl;
+    }
+    std::cout << "same values:          " << (same ? "yes" : "NO") << std::endl;
+
+    std::remove(path.c_str());
+    return same ? 0 : 1;
+}
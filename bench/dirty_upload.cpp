@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <chrono>
+#include <cppplot/dirty.h>
+#include <cppplot/synth.h>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+// Sweeps the fraction of channels updated per frame and reports how many bytes and upload calls the
+// dirty-interval path issues compared with re-uploading the whole line buffer. No GL context is needed,
+// only the upload plan is built.
+
+const int lineNum = 3300;
+const int lineSize = 2000;
+const size_t vertexBytes = 2 * sizeof(float);
+const int frames = 200;
+
+std::chrono::high_resolution_clock timer;
+
+const cppplot::Synth synth(1);
+
+int main()
+{
+    const std::vector<double> fractions = {0.01, 0.02, 0.05, 0.1, 0.25, 0.5, 1.0};
+    const std::vector<size_t> mergeGaps = {0, 4096, 65536};
+    const size_t fullBytes = static_cast<size_t>(lineNum) * lineSize * vertexBytes;
+
+    std::vector<cppplot::DirtyIntervals> dirtyLines(lineNum);
+    std::vector<int> channels(lineNum);
+    std::iota(channels.begin(), channels.end(), 0);
+
+    std::cout << "full upload: " << fullBytes << " bytes/frame" << std::endl;
+    std::cout << std::setw(10) << "fraction" << std::setw(10) << "gap" << std::setw(14) << "bytes/frame"
+              << std::setw(10) << "calls" << std::setw(10) << "saving" << std::setw(12) << "plan us" << std::endl;
+
+    for (const auto fraction : fractions)
+    {
+        const int updated = std::max(1, static_cast<int>(fraction * lineNum));
+
+        for (const auto gap : mergeGaps)
+        {
+            // the same channel subsets for every gap
+            uint64_t draws = 0;
+            size_t bytes = 0;
+            size_t calls = 0;
+            std::chrono::nanoseconds elapsed(0);
+
+            for (int f = 0; f < frames; f++)
+            {
+                // random subset of channels, as channels arrive independently
+                for (int k = 0; k < updated; k++)
+                {
+                    std::swap(channels[k], channels[k + synth.bits(draws++) % (lineNum - k)]);
+                }
+
+                const auto start = timer.now();
+                for (int k = 0; k < updated; k++)
+                {
+                    dirtyLines[channels[k]].markAll(lineSize);
+                }
+                const auto ranges = cppplot::collectUploadRanges(dirtyLines, lineSize, vertexBytes, gap);
+                for (auto &line : dirtyLines)
+                {
+                    line.clear();
+                }
+                elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(timer.now() - start);
+
+                bytes += cppplot::totalBytes(ranges);
+                calls += ranges.size();
+            }
+
+            const double bytesPerFrame = (double)bytes / frames;
+            std::cout << std::setw(10) << fraction << std::setw(10) << gap << std::setw(14) << (size_t)bytesPerFrame
+                      << std::setw(10) << calls / frames << std::setw(9) << std::fixed << std::setprecision(1)
+                      << fullBytes / bytesPerFrame << "x" << std::setw(12) << elapsed.count() / 1e3 / frames
+                      << std::defaultfloat << std::setprecision(6) << std::endl;
+        }
+    }
+}
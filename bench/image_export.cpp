@@ -0,0 +1,86 @@
+#include <chrono>
+#include <cmath>
+#include <cppplot/image_export.h>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef CPPPLOT_HAS_ZLIB
+#error "the PNG benchmark needs zlib, build with -DCPPPLOT_HAS_ZLIB -lz"
+#endif
+
+// Export throughput of plot-like 1200x800 frames: PNG and QOI through the ImageExporter worker pool
+// at increasing thread counts, and a single PNG encoded with row-parallel bands.
+
+const int width = 1200;
+const int height = 800;
+const int images = 48;
+
+std::chrono::high_resolution_clock timer;
+
+// Dark background with a few hundred coloured sine traces, similar to the line demo output
+std::vector<uint8_t> plotFrame(int seed)
+{
+    std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+    for (size_t i = 0; i < rgba.size(); i += 4)
+    {
+        rgba[i] = rgba[i + 1] = rgba[i + 2] = 26;
+        rgba[i + 3] = 255;
+    }
+    for (int line = 0; line < 300; line++)
+    {
+        const uint8_t r = 50 + (line * 37) % 200;
+        const uint8_t g = 50 + (line * 91) % 200;
+        const uint8_t b = 50 + (line * 53) % 200;
+        for (int x = 0; x < width; x++)
+        {
+            const float y = height * (0.5f + 0.45f * std::sin(0.01f * x + 0.1f * line + 0.05f * seed));
+            uint8_t *px = rgba.data() + (static_cast<size_t>(y) * width + x) * 4;
+            px[0] = r;
+            px[1] = g;
+            px[2] = b;
+        }
+    }
+    return rgba;
+}
+
+int main(int argc, char **argv)
+{
+    const std::string directory = argc > 1 ? argv[1] : ".";
+    const std::vector<uint8_t> frame = plotFrame(0);
+    const double megabytes = frame.size() / 1e6;
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto format : {cppplot::ImageFormat::Qoi, cppplot::ImageFormat::Png})
+    {
+        const std::string extension = format == cppplot::ImageFormat::Png ? "png" : "qoi";
+        for (size_t threads = 1; threads <= cppplot::hardwareThreads(); threads *= 2)
+        {
+            const auto start = timer.now();
+            {
+                cppplot::ImageExporter exporter(threads);
+                for (int i = 0; i < images; i++)
+                {
+                    exporter.submit(frame, width, height, directory + "/export_" + std::to_string(i % 4) + "." + extension);
+                }
+                exporter.finish();
+            }
+            const double seconds = std::chrono::duration<double>(timer.now() - start).count();
+            std::cout << extension << " exporter, " << threads << " threads: " << images / seconds << " images/s, "
+                      << images * megabytes / seconds << " MB/s raw" << std::endl;
+        }
+    }
+
+    for (size_t threads = 1; threads <= cppplot::hardwareThreads(); threads *= 2)
+    {
+        const auto start = timer.now();
+        size_t bytes = 0;
+        for (int i = 0; i < 8; i++)
+        {
+            bytes = cppplot::encodePng(frame.data(), width, height, threads).size();
+        }
+        const double ms = std::chrono::duration<double, std::milli>(timer.now() - start).count() / 8;
+        std::cout << "single png, " << threads << " bands: " << ms << " ms, " << bytes << " bytes" << std::endl;
+    }
+}
@@ -0,0 +1,438 @@
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cppplot/axis_transform.h>
+#include <cppplot/decimate.h>
+#include <cppplot/parallel.h>
+#include <cppplot/synth.h>
+#include <cstdint>
+#include <cstring>
+#include <emmintrin.h>
+#include <vector>
+
+// The CPU loops of a frame without any GL context, as Google Benchmark microbenchmarks to run under perf
+// on headless machines: the axis transform of xy points to clip space, the per-line colour fill of the
+// line demo, reading a ring buffer back in time order as roll does, and min/max decimation. Each kernel
+// has a scalar, an SSE2 and a multithreaded (SSE2 on every hardware thread) variant, at several sizes in
+// vertices; the SSE2 variants are checked against the scalar ones before timing.
+//
+//   kernels [--benchmark_filter=regex] [--benchmark_format=json] ...
+
+// vertices per line as in the line demo, and decimation input lines as long as a pixel column's worth
+// of 16 samples
+const size_t lineSize = 2000;
+const size_t columns = 1200;
+const size_t decimateLineSize = columns * 16;
+
+const cppplot::Synth synth(1);
+
+std::vector<float> randomXy(size_t vertices)
+{
+    std::vector<float> xy(vertices * 2);
+    synth.uniformXy(xy.data(), vertices, 0, 1000, -1, 1);
+    return xy;
+}
+
+cppplot::Axis axis(float min, float max)
+{
+    cppplot::Axis a;
+    a.domainMin = min;
+    a.domainMax = max;
+    return a;
+}
+
+const cppplot::Axis xAxis = axis(0, 1000);
+const cppplot::Axis yAxis = axis(-1, 1);
+
+// Clip = data * scale + offset for linear axes, x and y interleaved
+void transformSse2(const float *xy, float *out, size_t vertices, const cppplot::Axis &x, const cppplot::Axis &y)
+{
+    const float sx = (x.rangeMax - x.rangeMin) / (x.domainMax - x.domainMin);
+    const float sy = (y.rangeMax - y.rangeMin) / (y.domainMax - y.domainMin);
+    const __m128 scale = _mm_setr_ps(sx, sy, sx, sy);
+    const __m128 offset = _mm_setr_ps(x.rangeMin - x.domainMin * sx, y.rangeMin - y.domainMin * sy,
+                                      x.rangeMin - x.domainMin * sx, y.rangeMin - y.domainMin * sy);
+    size_t i = 0;
+    for (; i + 2 <= vertices; i += 2)
+    {
+        _mm_storeu_ps(out + i * 2, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(xy + i * 2), scale), offset));
+    }
+    for (; i < vertices; i++)
+    {
+        out[i * 2] = xy[i * 2] * sx + x.rangeMin - x.domainMin * sx;
+        out[i * 2 + 1] = xy[i * 2 + 1] * sy + y.rangeMin - y.domainMin * sy;
+    }
+}
+
+// Every vertex of line i takes the line's colour, 3 bytes per vertex
+void fillColorsScalar(const uint8_t *lineRgb, uint8_t *out, size_t lines, size_t size)
+{
+    for (size_t i = 0; i < lines; i++)
+    {
+        for (size_t j = 0; j < size; j++)
+        {
+            out[(i * size + j) * 3] = lineRgb[i * 3];
+            out[(i * size + j) * 3 + 1] = lineRgb[i * 3 + 1];
+            out[(i * size + j) * 3 + 2] = lineRgb[i * 3 + 2];
+        }
+    }
+}
+
+// 16 vertices per iteration as three 16 byte stores of a repeating pattern
+void fillColorsSse2(const uint8_t *lineRgb, uint8_t *out, size_t lines, size_t size)
+{
+    for (size_t i = 0; i < lines; i++)
+    {
+        alignas(16) uint8_t pattern[48];
+        for (int k = 0; k < 48; k++)
+        {
+            pattern[k] = lineRgb[i * 3 + k % 3];
+        }
+        const __m128i a = _mm_load_si128(reinterpret_cast<const __m128i *>(pattern));
+        const __m128i b = _mm_load_si128(reinterpret_cast<const __m128i *>(pattern + 16));
+        const __m128i c = _mm_load_si128(reinterpret_cast<const __m128i *>(pattern + 32));
+        uint8_t *line = out + i * size * 3;
+        size_t j = 0;
+        for (; j + 16 <= size; j += 16)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(line + j * 3), a);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(line + j * 3 + 16), b);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(line + j * 3 + 32), c);
+        }
+        std::memcpy(line + j * 3, pattern, (size - j) * 3);
+    }
+}
+
+// Vertices of each ring of size xy pairs in time order, the oldest at head
+void unrollRingScalar(const float *rings, float *out, size_t lines, size_t size, size_t head)
+{
+    for (size_t i = 0; i < lines; i++)
+    {
+        for (size_t j = 0; j < size; j++)
+        {
+            const size_t slot = (head + j) % size;
+            out[(i * size + j) * 2] = rings[(i * size + slot) * 2];
+            out[(i * size + j) * 2 + 1] = rings[(i * size + slot) * 2 + 1];
+        }
+    }
+}
+
+// The ring as two contiguous runs, copied 16 bytes at a time
+void unrollRingSse2(const float *rings, float *out, size_t lines, size_t size, size_t head)
+{
+    const auto copy = [](const float *from, float *to, size_t floats)
+    {
+        size_t k = 0;
+        for (; k + 4 <= floats; k += 4)
+        {
+            _mm_storeu_ps(to + k, _mm_loadu_ps(from + k));
+        }
+        std::memcpy(to + k, from + k, (floats - k) * sizeof(float));
+    };
+    for (size_t i = 0; i < lines; i++)
+    {
+        const float *ring = rings + i * size * 2;
+        float *line = out + i * size * 2;
+        copy(ring + head * 2, line, (size - head) * 2);
+        copy(ring, line + (size - head) * 2, head * 2);
+    }
+}
+
+// decimateMinMax with the y minimum and maximum of each bucket found 4 vertices at a time, lanes keeping
+// the first index of their extreme so the result matches the scalar version
+size_t decimateSse2(const float *xy, size_t count, size_t columns, float *out)
+{
+    if (count <= 2 * columns)
+    {
+        return cppplot::decimateMinMax(xy, count, columns, out);
+    }
+
+    size_t written = 0;
+    for (size_t c = 0; c < columns; c++)
+    {
+        const size_t begin = c * count / columns;
+        const size_t end = (c + 1) * count / columns;
+        __m128 low = _mm_set1_ps(xy[begin * 2 + 1]);
+        __m128 high = low;
+        __m128i lowIndex = _mm_set1_epi32(static_cast<int>(begin));
+        __m128i highIndex = lowIndex;
+        __m128i index = _mm_setr_epi32(static_cast<int>(begin), static_cast<int>(begin + 1), static_cast<int>(begin + 2),
+                                       static_cast<int>(begin + 3));
+        size_t i = begin;
+        for (; i + 4 <= end; i += 4)
+        {
+            // y of 4 consecutive vertices
+            const __m128 y = _mm_shuffle_ps(_mm_loadu_ps(xy + i * 2), _mm_loadu_ps(xy + i * 2 + 4), _MM_SHUFFLE(3, 1, 3, 1));
+            const __m128i below = _mm_castps_si128(_mm_cmplt_ps(y, low));
+            const __m128i above = _mm_castps_si128(_mm_cmpgt_ps(y, high));
+            low = _mm_min_ps(y, low);
+            high = _mm_max_ps(y, high);
+            lowIndex = _mm_or_si128(_mm_and_si128(below, index), _mm_andnot_si128(below, lowIndex));
+            highIndex = _mm_or_si128(_mm_and_si128(above, index), _mm_andnot_si128(above, highIndex));
+            index = _mm_add_epi32(index, _mm_set1_epi32(4));
+        }
+
+        alignas(16) float lows[4];
+        alignas(16) float highs[4];
+        alignas(16) int32_t lowIndices[4];
+        alignas(16) int32_t highIndices[4];
+        _mm_store_ps(lows, low);
+        _mm_store_ps(highs, high);
+        _mm_store_si128(reinterpret_cast<__m128i *>(lowIndices), lowIndex);
+        _mm_store_si128(reinterpret_cast<__m128i *>(highIndices), highIndex);
+        size_t lowAt = lowIndices[0];
+        size_t highAt = highIndices[0];
+        for (int lane = 1; lane < 4; lane++)
+        {
+            const size_t l = lowIndices[lane];
+            const size_t h = highIndices[lane];
+            lowAt = lows[lane] < xy[lowAt * 2 + 1] || (lows[lane] == xy[lowAt * 2 + 1] && l < lowAt) ? l : lowAt;
+            highAt = highs[lane] > xy[highAt * 2 + 1] || (highs[lane] == xy[highAt * 2 + 1] && h < highAt) ? h : highAt;
+        }
+        for (; i < end; i++)
+        {
+            lowAt = xy[i * 2 + 1] < xy[lowAt * 2 + 1] ? i : lowAt;
+            highAt = xy[i * 2 + 1] > xy[highAt * 2 + 1] ? i : highAt;
+        }
+
+        for (const size_t k : {std::min(lowAt, highAt), std::max(lowAt, highAt)})
+        {
+            out[written * 2] = xy[k * 2];
+            out[written * 2 + 1] = xy[k * 2 + 1];
+            written++;
+        }
+    }
+    return written;
+}
+
+// Splits lines across every hardware thread
+template <typename Fn>
+void perLineThreads(size_t lines, Fn fn)
+{
+    cppplot::parallelFor(lines, 0, [&](size_t, size_t begin, size_t end)
+                         { fn(begin, end); });
+}
+
+enum class Variant
+{
+    Scalar,
+    Sse2,
+    Threads
+};
+
+template <Variant V>
+void transform(benchmark::State &state)
+{
+    const size_t vertices = state.range(0);
+    const auto xy = randomXy(vertices);
+    std::vector<float> out(xy.size());
+    std::vector<float> expected(xy.size());
+    for (size_t i = 0; i < vertices; i++)
+    {
+        expected[i * 2] = xAxis.toClip(xy[i * 2]);
+        expected[i * 2 + 1] = yAxis.toClip(xy[i * 2 + 1]);
+    }
+
+    const auto run = [&]()
+    {
+        if constexpr (V == Variant::Scalar)
+        {
+            for (size_t i = 0; i < vertices; i++)
+            {
+                out[i * 2] = xAxis.toClip(xy[i * 2]);
+                out[i * 2 + 1] = yAxis.toClip(xy[i * 2 + 1]);
+            }
+        }
+        else if constexpr (V == Variant::Sse2)
+        {
+            transformSse2(xy.data(), out.data(), vertices, xAxis, yAxis);
+        }
+        else
+        {
+            cppplot::parallelFor(vertices, 0, [&](size_t, size_t begin, size_t end)
+                                 { transformSse2(xy.data() + begin * 2, out.data() + begin * 2, end - begin, xAxis, yAxis); });
+        }
+    };
+    run();
+    for (size_t i = 0; i < out.size(); i++)
+    {
+        if (std::fabs(out[i] - expected[i]) > 1e-5f)
+        {
+            state.SkipWithError("result differs from Axis::toClip");
+            return;
+        }
+    }
+
+    for (auto _ : state)
+    {
+        run();
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * vertices);
+    state.SetBytesProcessed(state.iterations() * vertices * 4 * sizeof(float));
+}
+
+template <Variant V>
+void fillColors(benchmark::State &state)
+{
+    const size_t lines = std::max<size_t>(1, state.range(0) / lineSize);
+    std::vector<uint8_t> lineRgb(lines * 3);
+    synth.bytes(lineRgb.data(), lineRgb.size());
+    std::vector<uint8_t> out(lines * lineSize * 3);
+    std::vector<uint8_t> expected(out.size());
+    fillColorsScalar(lineRgb.data(), expected.data(), lines, lineSize);
+
+    const auto run = [&]()
+    {
+        if constexpr (V == Variant::Scalar)
+        {
+            fillColorsScalar(lineRgb.data(), out.data(), lines, lineSize);
+        }
+        else if constexpr (V == Variant::Sse2)
+        {
+            fillColorsSse2(lineRgb.data(), out.data(), lines, lineSize);
+        }
+        else
+        {
+            perLineThreads(lines, [&](size_t begin, size_t end)
+                           { fillColorsSse2(lineRgb.data() + begin * 3, out.data() + begin * lineSize * 3, end - begin, lineSize); });
+        }
+    };
+    run();
+    if (out != expected)
+    {
+        state.SkipWithError("result differs from the scalar fill");
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        run();
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * lines * lineSize);
+    state.SetBytesProcessed(state.iterations() * out.size());
+}
+
+template <Variant V>
+void unrollRing(benchmark::State &state)
+{
+    const size_t lines = std::max<size_t>(1, state.range(0) / lineSize);
+    const auto rings = randomXy(lines * lineSize);
+    const size_t head = lineSize / 3;
+    std::vector<float> out(rings.size());
+    std::vector<float> expected(rings.size());
+    unrollRingScalar(rings.data(), expected.data(), lines, lineSize, head);
+
+    const auto run = [&]()
+    {
+        if constexpr (V == Variant::Scalar)
+        {
+            unrollRingScalar(rings.data(), out.data(), lines, lineSize, head);
+        }
+        else if constexpr (V == Variant::Sse2)
+        {
+            unrollRingSse2(rings.data(), out.data(), lines, lineSize, head);
+        }
+        else
+        {
+            perLineThreads(lines, [&](size_t begin, size_t end)
+                           { unrollRingSse2(rings.data() + begin * lineSize * 2, out.data() + begin * lineSize * 2, end - begin, lineSize, head); });
+        }
+    };
+    run();
+    if (out != expected)
+    {
+        state.SkipWithError("result differs from the scalar ring read");
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        run();
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * lines * lineSize);
+    state.SetBytesProcessed(state.iterations() * rings.size() * 2 * sizeof(float));
+}
+
+template <Variant V>
+void decimate(benchmark::State &state)
+{
+    const size_t lines = std::max<size_t>(1, state.range(0) / decimateLineSize);
+    std::vector<float> xy(lines * decimateLineSize * 2);
+    for (size_t i = 0; i < lines; i++)
+    {
+        synth.randomWalk(xy.data() + i * decimateLineSize * 2, decimateLineSize * 2, 0.01f, 0.0f, i);
+        for (size_t j = 0; j < decimateLineSize; j++)
+        {
+            xy[(i * decimateLineSize + j) * 2] = static_cast<float>(j);
+        }
+    }
+    std::vector<float> out(lines * columns * 4);
+    std::vector<float> expected(out.size());
+    for (size_t i = 0; i < lines; i++)
+    {
+        cppplot::decimateMinMax(xy.data() + i * decimateLineSize * 2, decimateLineSize, columns, expected.data() + i * columns * 4);
+    }
+
+    const auto range = [&](size_t begin, size_t end, auto kernel)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            kernel(xy.data() + i * decimateLineSize * 2, decimateLineSize, columns, out.data() + i * columns * 4);
+        }
+    };
+    const auto run = [&]()
+    {
+        if constexpr (V == Variant::Scalar)
+        {
+            range(0, lines, cppplot::decimateMinMax);
+        }
+        else if constexpr (V == Variant::Sse2)
+        {
+            range(0, lines, decimateSse2);
+        }
+        else
+        {
+            perLineThreads(lines, [&](size_t begin, size_t end)
+                           { range(begin, end, decimateSse2); });
+        }
+    };
+    run();
+    if (out != expected)
+    {
+        state.SkipWithError("result differs from decimateMinMax");
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        run();
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * lines * decimateLineSize);
+    state.SetBytesProcessed(state.iterations() * xy.size() * sizeof(float));
+}
+
+// vertices, from a frame's worth of new data to the line demo's 6.6M
+#define KERNEL_SIZES ->Arg(1 << 14)->Arg(1 << 18)->Arg(1 << 21)->Arg(lineSize * 3300)
+
+BENCHMARK(transform<Variant::Scalar>) KERNEL_SIZES;
+BENCHMARK(transform<Variant::Sse2>) KERNEL_SIZES;
+BENCHMARK(transform<Variant::Threads>) KERNEL_SIZES->UseRealTime();
+BENCHMARK(fillColors<Variant::Scalar>) KERNEL_SIZES;
+BENCHMARK(fillColors<Variant::Sse2>) KERNEL_SIZES;
+BENCHMARK(fillColors<Variant::Threads>) KERNEL_SIZES->UseRealTime();
+BENCHMARK(unrollRing<Variant::Scalar>) KERNEL_SIZES;
+BENCHMARK(unrollRing<Variant::Sse2>) KERNEL_SIZES;
+BENCHMARK(unrollRing<Variant::Threads>) KERNEL_SIZES->UseRealTime();
+BENCHMARK(decimate<Variant::Scalar>) KERNEL_SIZES;
+BENCHMARK(decimate<Variant::Sse2>) KERNEL_SIZES;
+BENCHMARK(decimate<Variant::Threads>) KERNEL_SIZES->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <chrono>
+#include <cppplot/decimate.h>
+#include <cppplot/mapped_file.h>
+#include <cppplot/synth.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+
+// Opening and plotting from a large recording of 8 interleaved int16 channels: the time to open the file
+// mapped and how much of it is resident afterwards, decimating a visible window of one channel straight
+// from the mapping with a cold and a warm page cache, against reading the whole file into memory and
+// converting the window to xy for decimateMinMax. The page cache is dropped with posix_fadvise before
+// the cold runs. POSIX only.
+//
+//   mapped_file [size MB] [path]
+
+const size_t channels = 8;
+const size_t windowFrames = 1 << 20;
+const size_t columns = 1200;
+
+std::chrono::high_resolution_clock timer;
+
+double ms(std::chrono::high_resolution_clock::duration d)
+{
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+// MB of the mapping currently in memory
+double residentMb(const cppplot::MappedFile &file)
+{
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    std::vector<unsigned char> pages((file.size() + page - 1) / page);
+    if (mincore(const_cast<uint8_t *>(file.data()), file.size(), pages.data()) != 0)
+    {
+        return -1;
+    }
+    size_t resident = 0;
+    for (const auto p : pages)
+    {
+        resident += p & 1;
+    }
+    return resident * page / (1024.0 * 1024.0);
+}
+
+void dropCache(const std::string &path)
+{
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const size_t megabytes = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1024;
+    const std::string path = argc > 2 ? argv[2] : "mapped_file_bench.raw";
+    const size_t frames = megabytes * 1024 * 1024 / (channels * sizeof(int16_t));
+
+    // a sine with noise per channel, written in blocks of 1M frames
+    {
+        const cppplot::Synth synth(1);
+        std::ofstream out(path, std::ios::binary);
+        std::vector<float> values(windowFrames);
+        std::vector<int16_t> block(windowFrames * channels);
+        for (size_t first = 0; first < frames; first += windowFrames)
+        {
+            const size_t count = std::min(windowFrames, frames - first);
+            for (size_t c = 0; c < channels; c++)
+            {
+                synth.sine(values.data(), count, 1e-5f * (c + 1), 0.0f, 20000.0f, 500.0f, c, first);
+                for (size_t i = 0; i < count; i++)
+                {
+                    block[i * channels + c] = static_cast<int16_t>(values[i]);
+                }
+            }
+            out.write(reinterpret_cast<const char *>(block.data()), count * channels * sizeof(int16_t));
+        }
+        if (!out)
+        {
+            std::cerr << "Could not write " << path << std::endl;
+            return 1;
+        }
+    }
+    std::cout << path << ": " << megabytes << " MB, " << channels << " int16 channels, " << frames << " frames"
+              << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+
+    dropCache(path);
+    auto start = timer.now();
+    const cppplot::SampleFile<int16_t> file(path, channels);
+    std::cout << "open mapped:          " << ms(timer.now() - start) << " ms, " << residentMb(file.file())
+              << " MB resident" << std::endl;
+
+    // the visible window in the middle of the recording, channel 3
+    const size_t first = frames / 2;
+    const auto window = file.channel(3).range(first, windowFrames);
+    std::vector<float> decimated(columns * 4);
+    size_t vertices = 0;
+
+    start = timer.now();
+    file.advise(first, windowFrames, cppplot::Access::WillNeed);
+    vertices = window.decimate(columns, decimated.data(), static_cast<double>(first));
+    std::cout << "decimate window cold: " << ms(timer.now() - start) << " ms, " << residentMb(file.file())
+              << " MB resident, " << vertices << " vertices" << std::endl;
+
+    start = timer.now();
+    vertices = window.decimate(columns, decimated.data(), static_cast<double>(first));
+    std::cout << "decimate window warm: " << ms(timer.now() - start) << " ms" << std::endl;
+
+    // the same through a copy: the whole file read, the window converted to xy, then decimated
+    dropCache(path);
+    start = timer.now();
+    std::vector<int16_t> samples(frames * channels);
+    {
+        std::ifstream in(path, std::ios::binary);
+        in.read(reinterpret_cast<char *>(samples.data()), samples.size() * sizeof(int16_t));
+    }
+    const double readMs = ms(timer.now() - start);
+    std::vector<float> xy(windowFrames * 2);
+    for (size_t i = 0; i < windowFrames; i++)
+    {
+        xy[i * 2] = static_cast<float>(first + i);
+        xy[i * 2 + 1] = samples[(first + i) * channels + 3];
+    }
+    std::vector<float> reference(columns * 4);
+    const size_t referenceVertices = cppplot::decimateMinMax(xy.data(), windowFrames, columns, reference.data());
+    std::cout << "read whole file:      " << readMs << " ms, then window to xy and decimated "
+              << ms(timer.now() - start) - readMs << " ms" << std::endl;
+
+    const bool same = referenceVertices == vertices && std::equal(reference.begin(), reference.begin() + vertices * 2, decimated.begin());
+    std::cout << "same vertices:        " << (same ? "yes" : "NO") << std::endl;
+
+    std::remove(path.c_str());
+    return same ? 0 : 1;
+}
@@ -0,0 +1,652 @@
+#include <GL/glew.h>
+#include <algorithm>
+#include <cmath>
+#include <cppplot/axis_transform.h>
+#include <cppplot/colormap.h>
+#include <cppplot/decimate.h>
+#include <cppplot/offscreen.h>
+#include <cppplot/profiler.h>
+#include <cppplot/resource_pool.h>
+#include <cppplot/synth.h>
+#include <cppplot/upload.h>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Reproducible plot workloads for catching regressions on build machines without a GPU (Mesa llvmpipe):
+// every scenario renders warmup + frames offscreen frames of the line, roll or scatter workload, ending
+// each with glFinish() so the draw stage includes the rasterization, and the frame-time distribution of
+// each stage and the bytes uploaded per frame are written as JSON. The data comes from Synth and the time
+// advances per frame, so every run uploads and draws exactly the same frames. Without scenarios the
+// default suite runs.
+//
+//   plot_bench [--out result.json] [workload [key=value ...]] ...
+//
+// workload is line, roll or scatter, followed by any of lines, samples, points, batch, stride,
+// upload=full|orphan|dirty, decimate=0|1, frames and warmup.
+
+#ifndef CPPPLOT_HAS_EGL
+#error "plot_bench needs EGL for offscreen rendering"
+#endif
+
+const int width = 1200;
+const int height = 800;
+// dirty ranges closer than this are sent in a single upload call, as in the line demo
+const size_t uploadMergeGap = 4096;
+
+enum class Upload
+{
+    // glBufferSubData of the whole buffer
+    Full,
+    // glBufferData of the whole buffer, letting the driver orphan the old storage
+    Orphan,
+    // glBufferSubData of the merged dirty ranges
+    Dirty
+};
+
+struct Scenario
+{
+    std::string workload = "line";
+    // line and roll: number of lines and samples per line (the ring size for roll)
+    size_t lines = 3300;
+    size_t samples = 2000;
+    // scatter: points held, the oldest being replaced first
+    size_t points = 1000000;
+    // roll: new samples per line per frame, scatter: new points per frame
+    size_t batch = 1000;
+    // line: every stride-th line changes per frame
+    size_t stride = 1;
+    Upload upload = Upload::Dirty;
+    // line and roll: min/max decimation to 2 vertices per pixel column before upload
+    bool decimate = false;
+    int frames = 30;
+    int warmup = 3;
+};
+
+const char *uploadName(Upload upload)
+{
+    switch (upload)
+    {
+    case Upload::Full:
+        return "full";
+    case Upload::Orphan:
+        return "orphan";
+    default:
+        return "dirty";
+    }
+}
+
+size_t parseCount(const std::string &key, const std::string &value)
+{
+    const auto parsed = std::strtoll(value.c_str(), nullptr, 10);
+    if (parsed <= 0)
+    {
+        throw std::runtime_error(key + " must be a positive number, not " + value);
+    }
+    return static_cast<size_t>(parsed);
+}
+
+void setParameter(Scenario &s, const std::string &argument)
+{
+    const auto equals = argument.find('=');
+    if (equals == std::string::npos)
+    {
+        throw std::runtime_error("expected key=value, got " + argument);
+    }
+    const auto key = argument.substr(0, equals);
+    const auto value = argument.substr(equals + 1);
+
+    if (key == "upload")
+    {
+        if (value != "full" && value != "orphan" && value != "dirty")
+        {
+            throw std::runtime_error("upload is full, orphan or dirty, not " + value);
+        }
+        s.upload = value == "full" ? Upload::Full : value == "orphan" ? Upload::Orphan
+                                                                      : Upload::Dirty;
+    }
+    else if (key == "decimate")
+    {
+        s.decimate = value != "0";
+    }
+    else if (key == "warmup")
+    {
+        s.warmup = std::max(0, std::atoi(value.c_str()));
+    }
+    else
+    {
+        const size_t count = parseCount(key, value);
+        if (key == "lines")
+        {
+            s.lines = count;
+        }
+        else if (key == "samples")
+        {
+            s.samples = std::max<size_t>(count, 2);
+        }
+        else if (key == "points")
+        {
+            s.points = count;
+        }
+        else if (key == "batch")
+        {
+            s.batch = count;
+        }
+        else if (key == "stride")
+        {
+            s.stride = count;
+        }
+        else if (key == "frames")
+        {
+            s.frames = static_cast<int>(count);
+        }
+        else
+        {
+            throw std::runtime_error("unknown parameter " + key);
+        }
+    }
+}
+
+// The line demo (every line changing per frame, then 5% of them), longer lines with and without
+// decimation, the roll demo and a long rolling history, and the scatter demo with fewer points, llvmpipe
+// being slow at instancing
+std::vector<Scenario> defaultSuite()
+{
+    std::vector<Scenario> suite;
+    const auto add = [&suite](const std::string &workload, std::vector<std::string> parameters)
+    {
+        Scenario s;
+        s.workload = workload;
+        for (const auto &p : parameters)
+        {
+            setParameter(s, p);
+        }
+        suite.push_back(s);
+    };
+    add("line", {"upload=full"});
+    add("line", {"upload=dirty"});
+    add("line", {"upload=dirty", "stride=20"});
+    add("line", {"lines=330", "samples=20000", "upload=dirty"});
+    add("line", {"lines=330", "samples=20000", "upload=dirty", "decimate=1"});
+    add("roll", {"lines=3", "samples=2000", "batch=1", "upload=dirty"});
+    add("roll", {"lines=64", "samples=100000", "batch=100", "upload=dirty"});
+    add("roll", {"lines=64", "samples=100000", "batch=100", "upload=dirty", "decimate=1"});
+    add("scatter", {"points=200000", "batch=1000", "upload=dirty"});
+    add("scatter", {"points=200000", "batch=1000", "upload=orphan"});
+    return suite;
+}
+
+struct Measurement
+{
+    cppplot::FrameProfiler profiler;
+    // bytes uploaded by each recorded frame
+    std::vector<uint64_t> bytes;
+    size_t vertices = 0;
+
+    explicit Measurement(size_t frames) :
+        profiler(frames)
+    {
+    }
+};
+
+// Sends the frame's changes of data with the scenario's upload backend and clears the dirty ranges,
+// returns the bytes sent
+size_t upload(Upload mode, std::vector<cppplot::DirtyIntervals> &dirty, size_t stride, const std::vector<float> &data)
+{
+    const size_t bytes = data.size() * sizeof(float);
+    switch (mode)
+    {
+    case Upload::Full:
+        glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, data.data());
+        break;
+    case Upload::Orphan:
+        glBufferData(GL_ARRAY_BUFFER, bytes, data.data(), GL_DYNAMIC_DRAW);
+        break;
+    default:
+        return cppplot::uploadDirty(GL_ARRAY_BUFFER, dirty, stride, 2 * sizeof(float), data.data(), uploadMergeGap);
+    }
+    for (auto &d : dirty)
+    {
+        d.clear();
+    }
+    return bytes;
+}
+
+// Renders the scenario's frames, frame(f) updating, uploading (returning the bytes sent) and drawing
+// frame f within the profiler's stages; only the last s.frames frames stay in the profiler ring
+template <typename Frame>
+void measure(const Scenario &s, Measurement &m, Frame frame)
+{
+    for (int f = 0; f < s.warmup + s.frames; f++)
+    {
+        m.profiler.beginFrame();
+        glClear(GL_COLOR_BUFFER_BIT);
+        const size_t bytes = frame(f);
+        {
+            const auto stage = m.profiler.scope(cppplot::Stage::Draw);
+            glFinish();
+        }
+        m.profiler.endFrame();
+        if (f >= s.warmup)
+        {
+            m.bytes.push_back(bytes);
+        }
+    }
+}
+
+GLuint createBuffer(size_t bytes, const void *data, GLenum usage)
+{
+    GLuint buffer;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER, bytes, data, usage);
+    return buffer;
+}
+
+// One RGB colour per line for all vertices of the line
+std::vector<uint8_t> lineColors(const cppplot::Synth &synth, size_t lines, size_t verticesPerLine)
+{
+    std::vector<uint8_t> perLine(lines * 3);
+    synth.bytes(perLine.data(), perLine.size(), 64, 255, 1);
+    std::vector<uint8_t> colors(lines * verticesPerLine * 3);
+    for (size_t i = 0; i < colors.size(); i++)
+    {
+        colors[i] = perLine[i / (verticesPerLine * 3) * 3 + i % 3];
+    }
+    return colors;
+}
+
+// The line demo: lines of samples sharing the x axis, every stride-th line rewritten each frame
+void runLine(const Scenario &s, cppplot::ResourcePool &pool, Measurement &m)
+{
+    const cppplot::Synth synth(1);
+    const bool decimated = s.decimate && s.samples > 2 * width;
+    const size_t stripLength = decimated ? 2 * width : s.samples;
+
+    std::vector<float> source(s.lines * s.samples * 2);
+    for (size_t i = 0; i < s.lines; i++)
+    {
+        for (size_t j = 0; j < s.samples; j++)
+        {
+            source[(i * s.samples + j) * 2] = static_cast<float>(j);
+        }
+    }
+    // the drawn vertices, the source itself unless decimated
+    std::vector<float> decimatedVertices(decimated ? s.lines * stripLength * 2 : 0);
+    const auto &drawn = decimated ? decimatedVertices : source;
+    std::vector<cppplot::DirtyIntervals> dirty(s.lines);
+
+    const cppplot::ShaderVariant<cppplot::AxisTransforms, cppplot::SeriesColor> shader(pool.shaders());
+    const auto colors = lineColors(synth, s.lines, stripLength);
+    const GLuint colorBuffer = createBuffer(colors.size(), colors.data(), GL_STATIC_DRAW);
+    const GLuint positionBuffer = createBuffer(drawn.size() * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    shader.setupAttributes(positionBuffer, colorBuffer);
+    shader.use();
+
+    cppplot::Axis xAxis;
+    xAxis.domainMin = 0.0f;
+    xAxis.domainMax = static_cast<float>(s.samples);
+    cppplot::Axis yAxis;
+    yAxis.domainMin = -0.5f;
+    yAxis.domainMax = 0.5f;
+    shader.setAxes(xAxis, yAxis);
+    m.vertices = s.lines * stripLength;
+
+    measure(s, m, [&](int frame)
+            {
+                {
+                    const auto stage = m.profiler.scope(cppplot::Stage::DataUpdate);
+                    const float phase = frame / 60.0f;
+                    for (size_t i = frame % s.stride; i < s.lines; i += s.stride)
+                    {
+                        float *line = source.data() + i * s.samples * 2;
+                        const float y0 = static_cast<float>(i) / s.lines + phase * 0.1f;
+                        for (size_t j = 0; j < s.samples; j++)
+                        {
+                            const float y = y0 + j * 0.1f / s.samples;
+                            line[j * 2 + 1] = y - std::lroundf(y);
+                        }
+                        if (decimated)
+                        {
+                            cppplot::decimateMinMax(line, s.samples, width, decimatedVertices.data() + i * stripLength * 2);
+                        }
+                        dirty[i].markAll(stripLength);
+                    }
+                }
+                size_t bytes;
+                {
+                    const auto stage = m.profiler.scope(cppplot::Stage::Upload);
+                    bytes = upload(s.upload, dirty, stripLength, drawn);
+                }
+                {
+                    const auto stage = m.profiler.scope(cppplot::Stage::Draw);
+                    for (size_t i = 0; i < s.lines; i++)
+                    {
+                        glDrawArrays(GL_LINE_STRIP, static_cast<GLint>(i * stripLength), static_cast<GLsizei>(stripLength));
+                    }
+                }
+                return bytes;
+            });
+
+    glDeleteBuffers(1, &positionBuffer);
+    glDeleteBuffers(1, &colorBuffer);
+}
+
+// The roll demo: a ring of samples per line receiving batch new samples each frame, the x axis following
+// the newest sample. Undecimated, each line is drawn as two strips from the ring; decimated, the whole
+// history is decimated in time order and uploaded every frame.
+void runRoll(const Scenario &s, cppplot::ResourcePool &pool, Measurement &m)
+{
+    const cppplot::Synth synth(1);
+    const bool decimated = s.decimate && s.samples > 2 * width;
+    const size_t stripLength = decimated ? 2 * width : s.samples;
+    const size_t batch = std::min(s.batch, s.samples);
+
+    // line i is a sine with noise from stream i, centred on its own band of the plot
+    std::vector<float> values(batch);
+    const auto generate = [&](size_t i, uint64_t first, size_t count, float *xy)
+    {
+        const float centre = -1.0f + (2.0f * i + 1.0f) / s.lines;
+        synth.sine(values.data(), count, 0.002f, 0.0f, 0.6f / s.lines, 0.1f / s.lines, i + 2, first);
+        for (size_t k = 0; k < count; k++)
+        {
+            const size_t slot = (first + k) % s.samples;
+            xy[slot * 2] = static_cast<float>(first + k);
+            xy[slot * 2 + 1] = centre + values[k];
+        }
+    };
+
+    // the ring is full from the start, the newest sample being number generated - 1
+    std::vector<float> source(s.lines * s.samples * 2);
+    uint64_t generated = 0;
+    for (; generated < s.samples; generated += batch)
+    {
+        for (size_t i = 0; i < s.lines; i++)
+        {
+            generate(i, generated, std::min<size_t>(batch, s.samples - generated), source.data() + i * s.samples * 2);
+        }
+    }
+    generated = s.samples;
+
+    std::vector<float> decimatedVertices(decimated ? s.lines * stripLength * 2 : 0);
+    std::vector<float> history(decimated ? s.samples * 2 : 0);
+    const auto &drawn = decimated ? decimatedVertices : source;
+    std::vector<cppplot::DirtyIntervals> dirty(s.lines);
+
+    const cppplot::ShaderVariant<cppplot::AxisTransforms, cppplot::SeriesColor> shader(pool.shaders());
+    const auto colors = lineColors(synth, s.lines, stripLength);
+    const GLuint colorBuffer = createBuffer(colors.size(), colors.data(), GL_STATIC_DRAW);
+    const GLuint positionBuffer = createBuffer(drawn.size() * sizeof(float), drawn.data(), GL_DYNAMIC_DRAW);
+    shader.setupAttributes(positionBuffer, colorBuffer);
+    shader.use();
+    cppplot::Axis xAxis;
+    m.vertices = s.lines * stripLength;
+
+    measure(s, m, [&](int)
+            {
+                {
+                    const auto stage = m.profiler.scope(cppplot::Stage::DataUpdate);
+                    const size_t head = generated % s.samples;
+                    for (size_t i = 0; i < s.lines; i++)
+                    {
+                        float *ring = source.data() + i * s.samples * 2;
+                        generate(i, generated, batch, ring);
+                        if (decimated)
+                        {
+                            // oldest first, after this frame's batch
+                            const size_t oldest = (head + batch) % s.samples;
+                            std::copy(ring + oldest * 2, ring + s.samples * 2, history.begin());
+                            std::copy(ring, ring + oldest * 2, history.begin() + (s.samples - oldest) * 2);
+                            cppplot::decimateMinMax(history.data(), s.samples, width, decimatedVertices.data() + i * stripLength * 2);
+                            dirty[i].markAll(stripLength);
+                        }
+                        else
+                        {
+                            dirty[i].mark(head, std::min(head + batch, s.samples));
+                            dirty[i].mark(0, head + batch > s.samples ? head + batch - s.samples : 0);
+                        }
+                    }
+                    generated += batch;
+                }
+                size_t bytes;
+                {
+                    const auto stage = m.profiler.scope(cppplot::Stage::Upload);
+                    bytes = upload(s.upload, dirty, stripLength, drawn);
+                }
+                {
+                    const auto stage = m.profiler.scope(cppplot::Stage::Draw);
+                    xAxis.domainMin = static_cast<float>(generated - s.samples);
+                    xAxis.domainMax = static_cast<float>(generated - 1);
+                    shader.setAxes(xAxis, cppplot::Axis());
+                    const size_t oldest = generated % s.samples;
+                    for (size_t i = 0; i < s.lines; i++)
+                    {
+                        const auto first = static_cast<GLint>(i * stripLength);
+                        if (decimated)
+                        {
+                            glDrawArrays(GL_LINE_STRIP, first, static_cast<GLsizei>(stripLength));
+                            continue;
+                        }
+                        glDrawArrays(GL_LINE_STRIP, first + static_cast<GLint>(oldest), static_cast<GLsizei>(s.samples - oldest));
+                        glDrawArrays(GL_LINE_STRIP, first, static_cast<GLsizei>(oldest));
+                    }
+                }
+                return bytes;
+            });
+
+    glDeleteBuffers(1, &positionBuffer);
+    glDeleteBuffers(1, &colorBuffer);
+}
+
+// The scatter demo: instanced squares coloured through a colormap, batch new points replacing the oldest
+// each frame
+void runScatter(const Scenario &s, cppplot::ResourcePool &pool, Measurement &m)
+{
+    if (s.decimate)
+    {
+        throw std::runtime_error("decimation applies to the line and roll workloads");
+    }
+    const cppplot::Synth synth(1);
+    const size_t batch = std::min(s.batch, s.points);
+    std::vector<float> positions(s.points * 2);
+    synth.uniformXy(positions.data(), s.points, -1, 1, -1, 1, 0);
+    uint64_t generated = s.points;
+    std::vector<uint8_t> values(s.points);
+    synth.bytes(values.data(), values.size(), 0, 255, 1);
+    std::vector<cppplot::DirtyIntervals> dirty(1);
+
+    const cppplot::ShaderVariant<cppplot::PointShape<cppplot::Shape::Square>, cppplot::AxisTransforms,
+                                 cppplot::ScalarColor<uint8_t>>
+        shader(pool.shaders());
+    const GLuint valueBuffer = createBuffer(values.size(), values.data(), GL_STATIC_DRAW);
+    const GLuint positionBuffer = createBuffer(positions.size() * sizeof(float), positions.data(), GL_DYNAMIC_DRAW);
+    shader.setupAttributes(positionBuffer, valueBuffer);
+    shader.use();
+    shader.setSize(0.001f, static_cast<float>(height) / width);
+    shader.setAxes(cppplot::Axis(), cppplot::Axis());
+    shader.setColormap(cppplot::colormapTexture(pool, cppplot::Colormap::Viridis));
+    shader.setColorRange(0, 255);
+    m.vertices = s.points;
+
+    measure(s, m, [&](int)
+            {
+                {
+                    const auto stage = m.profiler.scope(cppplot::Stage::DataUpdate);
+                    const size_t head = generated % s.points;
+                    const size_t first = std::min(batch, s.points - head);
+                    synth.uniformXy(positions.data() + head * 2, first, -1, 1, -1, 1, 0, generated);
+                    synth.uniformXy(positions.data(), batch - first, -1, 1, -1, 1, 0, generated + first);
+                    dirty[0].mark(head, head + first);
+                    dirty[0].mark(0, batch - first);
+                    generated += batch;
+                }
+                size_t bytes;
+                {
+                    const auto stage = m.profiler.scope(cppplot::Stage::Upload);
+                    bytes = upload(s.upload, dirty, s.points, positions);
+                }
+                {
+                    const auto stage = m.profiler.scope(cppplot::Stage::Draw);
+                    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(s.points));
+                }
+                return bytes;
+            });
+
+    glDeleteBuffers(1, &positionBuffer);
+    glDeleteBuffers(1, &valueBuffer);
+}
+
+void writeStats(std::ostream &os, const cppplot::StageStats &stats)
+{
+    os << "{\"mean\": " << stats.mean << ", \"p50\": " << stats.p50 << ", \"p95\": " << stats.p95
+       << ", \"p99\": " << stats.p99 << ", \"max\": " << stats.max << "}";
+}
+
+void writeScenario(std::ostream &os, const Scenario &s, const Measurement &m)
+{
+    uint64_t bytes = 0;
+    for (const auto b : m.bytes)
+    {
+        bytes += b;
+    }
+    const auto frame = m.profiler.stats(cppplot::Stage::Frame);
+
+    os << "    {\"workload\": \"" << s.workload << "\", \"lines\": " << (s.workload == "scatter" ? 0 : s.lines)
+       << ", \"samples\": " << (s.workload == "scatter" ? 0 : s.samples)
+       << ", \"points\": " << (s.workload == "scatter" ? s.points : 0)
+       << ", \"batch\": " << (s.workload == "line" ? 0 : s.batch)
+       << ", \"stride\": " << (s.workload == "line" ? s.stride : 1)
+       << ", \"upload\": \"" << uploadName(s.upload) << "\", \"decimate\": " << (s.decimate ? "true" : "false")
+       << ", \"frames\": " << s.frames << ", \"vertices\": " << m.vertices
+       << ",\n     \"fps\": " << (frame.mean > 0 ? 1000.0 / frame.mean : 0.0) << ", \"ms\": {";
+    const cppplot::Stage stages[] = {cppplot::Stage::Frame, cppplot::Stage::DataUpdate, cppplot::Stage::Upload,
+                                     cppplot::Stage::Draw};
+    for (const auto stage : stages)
+    {
+        os << (stage == cppplot::Stage::Frame ? "" : ",") << "\n      \""
+           << m.profiler.channelName(static_cast<size_t>(stage)) << "\": ";
+        writeStats(os, m.profiler.stats(stage));
+    }
+    os << "},\n     \"bytes_uploaded\": {\"total\": " << bytes << ", \"per_frame\": ";
+    writeStats(os, cppplot::summarize(std::vector<double>(m.bytes.begin(), m.bytes.end())));
+    os << "}}";
+}
+
+int main(int argc, char **argv)
+{
+    std::string outPath;
+    std::vector<Scenario> scenarios;
+    try
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const std::string argument = argv[i];
+            if (argument == "--out" && i + 1 < argc)
+            {
+                outPath = argv[++i];
+            }
+            else if (argument == "line" || argument == "roll" || argument == "scatter")
+            {
+                scenarios.emplace_back();
+                scenarios.back().workload = argument;
+            }
+            else if (!scenarios.empty())
+            {
+                setParameter(scenarios.back(), argument);
+            }
+            else
+            {
+                throw std::runtime_error("unknown argument " + argument);
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+    if (scenarios.empty())
+    {
+        scenarios = defaultSuite();
+    }
+
+    cppplot::OffscreenContext context;
+    glewExperimental = GL_TRUE;
+    glewInit();
+    cppplot::Framebuffer framebuffer(width, height);
+    framebuffer.bind();
+    glViewport(0, 0, width, height);
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+
+    cppplot::ResourcePool pool;
+    GLuint vao;
+    glGenVertexArrays(1, &vao);
+
+    std::ostringstream json;
+    json << "{\n  \"renderer\": \"" << glGetString(GL_RENDERER) << "\",\n  \"width\": " << width
+         << ", \"height\": " << height << ",\n  \"scenarios\": [\n";
+    int failures = 0;
+    int written = 0;
+    for (size_t i = 0; i < scenarios.size(); i++)
+    {
+        const auto &s = scenarios[i];
+        std::cerr << "[" << i + 1 << "/" << scenarios.size() << "] " << s.workload << " ..." << std::endl;
+        // a fresh VAO per scenario, the variants differ in their attributes
+        glDeleteVertexArrays(1, &vao);
+        glGenVertexArrays(1, &vao);
+        glBindVertexArray(vao);
+
+        Measurement m(s.frames);
+        try
+        {
+            if (s.workload == "roll")
+            {
+                runRoll(s, pool, m);
+            }
+            else if (s.workload == "scatter")
+            {
+                runScatter(s, pool, m);
+            }
+            else
+            {
+                runLine(s, pool, m);
+            }
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << s.workload << ": " << e.what() << std::endl;
+            failures++;
+            continue;
+        }
+        if (glGetError() != GL_NO_ERROR)
+        {
+            std::cerr << s.workload << ": GL error" << std::endl;
+            failures++;
+        }
+        json << (written++ > 0 ? ",\n" : "");
+        writeScenario(json, s, m);
+    }
+    json << "\n  ]\n}\n";
+    glDeleteVertexArrays(1, &vao);
+
+    if (outPath.empty())
+    {
+        std::cout << json.str();
+    }
+    else
+    {
+        std::ofstream file(outPath);
+        file << json.str();
+        if (!file)
+        {
+            std::cerr << "could not write " << outPath << std::endl;
+            return 1;
+        }
+    }
+    return failures ? 1 : 0;
+}
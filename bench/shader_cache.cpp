@@ -0,0 +1,98 @@
+#include <GL/glew.h>
+#include <chrono>
+#include <cppplot/offscreen.h>
+#include <cppplot/shader.h>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Startup cost of building the shader programs of many plots: a cold start compiles every program and
+// fills the binary cache, a warm start loads the binaries. Each program is requested twice, as by two
+// plots of the same type, the second request being served without any GL work.
+
+#ifndef CPPPLOT_HAS_EGL
+#error "shader_cache needs EGL for offscreen rendering"
+#endif
+
+const int plotTypes = 32;
+const char *cacheDir = "shader_cache_bench";
+
+std::chrono::high_resolution_clock timer;
+
+std::string vertexSource(int type)
+{
+    return "#version 330 core\n#define PLOT_TYPE " + std::to_string(type) + R"(
+        layout (location = 0) in vec2 aPos;
+        layout (location = 1) in vec3 aColor;
+        uniform vec2 uScale;
+        uniform vec2 uOffset;
+        out vec3 vColor;
+        void main()
+        {
+            vec2 p = aPos * uScale + uOffset;
+            for (int i = 0; i < PLOT_TYPE % 4; i++)
+            {
+                p = sign(p) * log(1.0 + abs(p));
+            }
+            vColor = aColor / 255.0;
+            gl_Position = vec4(p, 0.0, 1.0);
+        }
+    )";
+}
+
+std::string fragmentSource(int type)
+{
+    return "#version 330 core\n#define PLOT_TYPE " + std::to_string(type) + R"(
+        in vec3 vColor;
+        out vec4 FragColor;
+        void main()
+        {
+            FragColor = vec4(vColor * (0.5 + 0.5 * float(PLOT_TYPE % 3)), 0.7);
+        }
+    )";
+}
+
+double buildAll(cppplot::ShaderManager &shaders)
+{
+    const auto start = timer.now();
+    for (int copy = 0; copy < 2; copy++)
+    {
+        for (int type = 0; type < plotTypes; type++)
+        {
+            shaders.program(vertexSource(type), fragmentSource(type));
+        }
+    }
+    glFinish();
+    return std::chrono::duration<double, std::milli>(timer.now() - start).count();
+}
+
+int main()
+{
+    // keep the driver's own shader cache out of the cold measurement
+    //setenv
+    cppplot::OffscreenContext context;
+    glewExperimental = GL_TRUE;
+    glewInit();
+    std::cout << "GL: " << glGetString(GL_RENDERER) << std::endl;
+
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    std::cout << "program binary formats: " << formats << std::endl;
+
+    std::cout << std::fixed << std::setprecision(2);
+    {
+        cppplot::ShaderManager shaders(cacheDir);
+        const double ms = buildAll(shaders);
+        std::cout << "cold  " << std::setw(8) << ms << " ms  compiled " << shaders.compiled() << " loaded "
+                  << shaders.loaded() << " shared " << shaders.shared() << std::endl;
+    }
+    {
+        cppplot::ShaderManager shaders(cacheDir);
+        const double ms = buildAll(shaders);
+        std::cout << "warm  " << std::setw(8) << ms << " ms  compiled " << shaders.compiled() << " loaded "
+                  << shaders.loaded() << " shared " << shaders.shared() << std::endl;
+    }
+    std::filesystem::remove_all(cacheDir);
+}
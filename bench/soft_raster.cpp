@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cppplot/soft_raster.h>
+#include <cppplot/synth.h>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Software rasteriser throughput at increasing thread counts: the line demo's 3300 x 2000 line plot, 1M
+// scatter points and 2000 bars, each at 1200 x 800. Images rendered with several threads are compared
+// with the single threaded ones, tiles must make the result independent of the thread count. No GL
+// context or driver is needed.
+//
+//   soft_raster [max threads]
+
+const int width = 1200;
+const int height = 800;
+const int lineNum = 3300;
+const int lineSize = 2000;
+const int pointNum = 1000000;
+const int barNum = 2000;
+const int runs = 5;
+
+std::chrono::high_resolution_clock timer;
+
+const cppplot::Synth synth(1);
+
+struct Plot
+{
+    std::string name;
+    cppplot::Scene scene;
+};
+
+// Same data as the line demo after its first update
+void lineData(std::vector<float> &xy, std::vector<uint8_t> &rgb)
+{
+    std::vector<uint8_t> lineColors(lineNum * 3);
+    synth.bytes(lineColors.data(), lineColors.size(), 0, 255, 0);
+    for (int i = 0; i < lineNum; i++)
+    {
+        const uint8_t r = lineColors[i * 3];
+        const uint8_t g = lineColors[i * 3 + 1];
+        const uint8_t b = lineColors[i * 3 + 2];
+        const float y0 = (float)i / (float)lineNum;
+        for (int j = 0; j < lineSize; j++)
+        {
+            const size_t v = static_cast<size_t>(i) * lineSize + j;
+            const float y = y0 + j * 0.1f / lineSize;
+            xy[v * 2] = (float)j;
+            xy[v * 2 + 1] = y - std::lroundf(y);
+            rgb[v * 3] = r;
+            rgb[v * 3 + 1] = g;
+            rgb[v * 3 + 2] = b;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const size_t maxThreads = argc > 1 ? std::max(1, std::atoi(argv[1])) : cppplot::hardwareThreads();
+    std::vector<float> lineXy(static_cast<size_t>(lineNum) * lineSize * 2);
+    std::vector<uint8_t> lineRgb(static_cast<size_t>(lineNum) * lineSize * 3);
+    lineData(lineXy, lineRgb);
+
+    std::vector<float> pointXy(pointNum * 2);
+    std::vector<uint8_t> pointRgb(pointNum * 3);
+    synth.uniformXy(pointXy.data(), pointNum, -1, 1, -1, 1, 1);
+    synth.bytes(pointRgb.data(), pointRgb.size(), 0, 255, 2);
+
+    std::vector<float> barXy(barNum * 2);
+    for (int i = 0; i < barNum; i++)
+    {
+        barXy[i * 2] = i;
+        barXy[i * 2 + 1] = std::sin(i * 0.01f) * std::sin(i * 0.0023f);
+    }
+
+    std::vector<Plot> plots(3);
+    for (auto &plot : plots)
+    {
+        plot.scene.width = width;
+        plot.scene.height = height;
+    }
+
+    plots[0].name = "lines";
+    plots[0].scene.x.domainMin = 0.0f;
+    plots[0].scene.x.domainMax = lineSize;
+    plots[0].scene.y.domainMin = -0.5f;
+    plots[0].scene.y.domainMax = 0.5f;
+    cppplot::Series lines;
+    lines.xy = lineXy.data();
+    lines.count = static_cast<size_t>(lineNum) * lineSize;
+    lines.stripLength = lineSize;
+    lines.rgb = lineRgb.data();
+    plots[0].scene.series.push_back(lines);
+
+    plots[1].name = "points";
+    cppplot::Series points;
+    points.kind = cppplot::SeriesKind::Points;
+    points.xy = pointXy.data();
+    points.count = pointNum;
+    points.rgb = pointRgb.data();
+    points.size = 0.5f;
+    plots[1].scene.series.push_back(points);
+
+    plots[2].name = "bars";
+    plots[2].scene.x.domainMin = -0.5f;
+    plots[2].scene.x.domainMax = barNum - 0.5f;
+    cppplot::Series bars;
+    bars.kind = cppplot::SeriesKind::Bars;
+    bars.xy = barXy.data();
+    bars.count = barNum;
+    bars.color = {90, 160, 230};
+    bars.size = 0.8f;
+    plots[2].scene.series.push_back(bars);
+
+    std::cout << std::setw(8) << "plot" << std::setw(9) << "threads" << std::setw(10) << "p50 ms" << std::setw(10)
+              << "min ms" << std::setw(12) << "identical" << std::endl;
+
+    int mismatches = 0;
+    for (const auto &plot : plots)
+    {
+        std::vector<uint8_t> reference;
+        for (size_t threads = 1; threads <= maxThreads; threads *= 2)
+        {
+            cppplot::SoftRasterizer rasterizer(threads);
+            std::vector<double> times;
+            for (int r = 0; r < runs; r++)
+            {
+                const auto start = timer.now();
+                rasterizer.render(plot.scene);
+                times.push_back(std::chrono::duration<double, std::milli>(timer.now() - start).count());
+            }
+            std::sort(times.begin(), times.end());
+
+            const auto &image = rasterizer.render(plot.scene);
+            if (reference.empty())
+            {
+                reference = image;
+            }
+            const bool identical = image == reference;
+            mismatches += !identical;
+
+            std::cout << std::setw(8) << plot.name << std::setw(9) << threads << std::fixed << std::setprecision(1)
+                      << std::setw(10) << times[times.size() / 2] << std::setw(10) << times.front() << std::setw(12)
+                      << (identical ? "yes" : "NO") << std::defaultfloat << std::endl;
+
+            if (threads < maxThreads && threads * 2 > maxThreads)
+            {
+                threads = maxThreads / 2;
+            }
+        }
+    }
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <chrono>
+#include <cppplot/spatial_index.h>
+#include <cppplot/synth.h>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// Build, streaming update and hover query costs of the scatter demo's spatial index: 30M points in the
+// scatter's data bounds, 1000 new points per frame evicting the oldest, picks with a radius of about two
+// pixels. A sample of the picks is checked against a brute force search. No GL context is needed.
+//
+//   spatial_index [points]
+
+const float aspectRatio = 800.0f / 1200.0f;
+const int newDataNum = 1000;
+const int updateFrames = 2000;
+const int queries = 100000;
+const int checkedQueries = 200;
+const float pickRadius = 2.0f * (2.0f / aspectRatio) / 1200.0f;
+
+std::chrono::high_resolution_clock timer;
+
+// initial points from stream 0, streamed points from stream 1 and cursor positions from stream 2
+const cppplot::Synth synth(1);
+
+void randomPoints(std::vector<float> &xy, uint64_t stream, uint64_t offset = 0)
+{
+    synth.uniformXy(xy.data(), xy.size() / 2, -1 / aspectRatio, 1 / aspectRatio, -1, 1, stream, offset);
+}
+
+double microseconds(std::chrono::high_resolution_clock::duration d)
+{
+    return std::chrono::duration<double, std::micro>(d).count();
+}
+
+int main(int argc, char **argv)
+{
+    const size_t points = argc > 1 ? std::max(1, std::atoi(argv[1])) : 30000000;
+    std::vector<float> data(points * 2);
+    randomPoints(data, 0);
+
+    cppplot::SpatialIndex index(points, -1 / aspectRatio, 1 / aspectRatio, -1, 1);
+    std::cout << points << " points, " << index.cellCount() << " cells, " << index.memoryBytes() / (1024 * 1024)
+              << " MB" << std::endl;
+
+    // build: fill the empty ring in frame-sized pushes
+    auto start = timer.now();
+    for (size_t i = 0; i < points; i += newDataNum)
+    {
+        index.push(data.data() + i * 2, std::min<size_t>(newDataNum, points - i));
+    }
+    std::cout << "build:  " << std::fixed << std::setprecision(1) << microseconds(timer.now() - start) / 1e3 << " ms ("
+              << std::setprecision(2) << microseconds(timer.now() - start) * 1e3 / points << " ns/point)" << std::endl;
+
+    // update: steady state, every point pushed evicts the oldest
+    std::vector<float> frame(newDataNum * 2);
+    std::vector<double> frameTimes;
+    size_t head = 0;
+    for (int f = 0; f < updateFrames; f++)
+    {
+        randomPoints(frame, 1, static_cast<uint64_t>(f) * newDataNum);
+        start = timer.now();
+        index.push(frame.data(), newDataNum);
+        frameTimes.push_back(microseconds(timer.now() - start));
+
+        std::copy(frame.begin(), frame.end(), data.begin() + head * 2);
+        head = (head + newDataNum) % points;
+    }
+    std::sort(frameTimes.begin(), frameTimes.end());
+    std::cout << "update: " << std::setprecision(1) << frameTimes[frameTimes.size() / 2] << " us p50, "
+              << frameTimes[frameTimes.size() * 99 / 100] << " us p99 per " << newDataNum << " points" << std::endl;
+
+    // query: random cursor positions
+    std::vector<float> cursors(queries * 2);
+    randomPoints(cursors, 2);
+    std::vector<double> queryTimes;
+    size_t hits = 0;
+    int mismatches = 0;
+    for (int q = 0; q < queries; q++)
+    {
+        const float x = cursors[q * 2];
+        const float y = cursors[q * 2 + 1];
+        start = timer.now();
+        const auto hit = index.pick(x, y, pickRadius);
+        queryTimes.push_back(microseconds(timer.now() - start));
+        hits += hit.has_value();
+
+        if (q < checkedQueries)
+        {
+            float best = pickRadius * pickRadius;
+            bool found = false;
+            for (size_t i = 0; i < points; i++)
+            {
+                const float dx = data[i * 2] - x;
+                const float dy = data[i * 2 + 1] - y;
+                if (dx * dx + dy * dy <= best)
+                {
+                    best = dx * dx + dy * dy;
+                    found = true;
+                }
+            }
+            if (found != hit.has_value() || (found && hit->distance * hit->distance > best * 1.0001f))
+            {
+                mismatches++;
+            }
+        }
+    }
+    std::sort(queryTimes.begin(), queryTimes.end());
+    std::cout << "query:  " << std::setprecision(2) << queryTimes[queryTimes.size() / 2] << " us p50, "
+              << queryTimes[queryTimes.size() * 99 / 100] << " us p99, " << queryTimes.back() << " us max, radius "
+              << std::setprecision(4) << pickRadius << ", " << 100.0 * hits / queries << "% hits" << std::endl;
+    std::cout << "brute force check: " << mismatches << " mismatches in " << checkedQueries << " queries" << std::endl;
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,123 @@
+#include <cmath>
+#include <cppplot/frame_stream.h>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Loopback harness for the notebook frame stream: encodes static, rolling and fully animated plots,
+// sends the messages through an in-memory channel to a FrameReceiver, checks the reconstructed frame
+// matches the source once pending tiles are drained, and reports bytes per frame.
+
+const int width = 1200;
+const int height = 800;
+const int frames = 120;
+
+void clear(std::vector<uint8_t> &rgba, int x0, int x1)
+{
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = x0; x < x1; x++)
+        {
+            uint8_t *px = rgba.data() + (static_cast<size_t>(y) * width + x) * 4;
+            px[0] = px[1] = px[2] = 26;
+            px[3] = 255;
+        }
+    }
+}
+
+void plotColumn(std::vector<uint8_t> &rgba, int x, float phase)
+{
+    for (int line = 0; line < 8; line++)
+    {
+        const float v = 0.5f + 0.4f * std::sin(0.02f * x + phase + line);
+        uint8_t *px = rgba.data() + (static_cast<size_t>(v * (height - 1)) * width + x) * 4;
+        px[0] = 60 + line * 24;
+        px[1] = 200 - line * 18;
+        px[2] = 120;
+    }
+}
+
+// scenario 0: static, 1: rolling (a 10 px strip updates per frame), 2: every line moves
+void renderFrame(std::vector<uint8_t> &rgba, int scenario, int frame)
+{
+    if (scenario == 0 && frame > 0)
+    {
+        return;
+    }
+    if (scenario == 1 && frame > 0)
+    {
+        const int x0 = (frame * 10) % width;
+        clear(rgba, x0, x0 + 10);
+        for (int x = x0; x < x0 + 10; x++)
+        {
+            plotColumn(rgba, x, 0.05f * frame);
+        }
+        return;
+    }
+    clear(rgba, 0, width);
+    for (int x = 0; x < width; x++)
+    {
+        plotColumn(rgba, x, 0.05f * frame);
+    }
+}
+
+int main()
+{
+    const char *names[] = {"static", "rolling", "animated"};
+    const size_t budgets[] = {0, 8 * 1024};
+    bool ok = true;
+
+    std::cout << "raw frame: " << width * height * 4 << " bytes" << std::endl;
+    for (int scenario = 0; scenario < 3; scenario++)
+    {
+        for (const auto budget : budgets)
+        {
+            std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+            cppplot::FrameStreamer streamer(width, height, 64, budget);
+            cppplot::FrameReceiver receiver;
+            std::vector<std::vector<uint8_t>> channel;
+
+            size_t total = 0;
+            size_t first = 0;
+            size_t largest = 0;
+            for (int f = 0; f < frames; f++)
+            {
+                renderFrame(rgba, scenario, f);
+                channel.push_back(streamer.encode(rgba.data()));
+                const size_t bytes = channel.back().size();
+                first = f == 0 ? bytes : first;
+                total += bytes;
+                largest = std::max(largest, bytes);
+
+                for (const auto &message : channel)
+                {
+                    ok = receiver.apply(message.data(), message.size()) && ok;
+                }
+                channel.clear();
+            }
+
+            // drain the tiles deferred by the budget, then the receiver must hold the last frame
+            int drain = 0;
+            while (drain < 1000)
+            {
+                const auto message = streamer.encode(rgba.data());
+                ok = receiver.apply(message.data(), message.size()) && ok;
+                drain++;
+                if ((message[14] | message[15] << 8) == 0)
+                {
+                    break;
+                }
+            }
+            const bool match = receiver.pixels() == rgba;
+            ok = ok && match;
+
+            std::cout << std::left << std::setw(10) << names[scenario] << " budget " << std::setw(7)
+                      << (budget ? std::to_string(budget) : "none") << std::right << " first " << std::setw(8)
+                      << first << " avg " << std::setw(8) << total / frames << " max " << std::setw(8) << largest
+                      << " bytes/frame, drained in " << drain << ", " << (match ? "match" : "MISMATCH")
+                      << std::endl;
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <chrono>
+#include <cppplot/synth.h>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Synthetic data generation for the scatter demo's 30M points (positions and one colour value each) and
+// a 6.6M sample sine and random walk workload: std::rand as the demos used it, against Synth on
+// increasing thread counts. Synth's output must not depend on the thread count.
+//
+//   synth [max threads]
+
+const size_t points = 30000000;
+const size_t samples = 3300 * 2000;
+const int runs = 3;
+
+std::chrono::high_resolution_clock timer;
+
+template <typename Fn>
+double bestMs(Fn fn)
+{
+    double best = 1e30;
+    for (int r = 0; r < runs; r++)
+    {
+        const auto start = timer.now();
+        fn();
+        best = std::min(best, std::chrono::duration<double, std::milli>(timer.now() - start).count());
+    }
+    return best;
+}
+
+void report(const std::string &name, const std::string &threads, double ms, size_t bytes, const char *identical)
+{
+    std::cout << std::setw(10) << name << std::setw(10) << threads << std::fixed << std::setprecision(1) << std::setw(10)
+              << ms << std::setprecision(2) << std::setw(10) << bytes / ms / 1e6 << std::setw(12) << identical
+              << std::defaultfloat << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    const size_t maxThreads = argc > 1 ? std::max(1, std::atoi(argv[1])) : cppplot::hardwareThreads();
+
+    std::vector<float> xy(points * 2);
+    std::vector<uint8_t> values(points);
+    std::vector<float> series(samples);
+    const size_t pointBytes = xy.size() * sizeof(float) + values.size();
+    const size_t seriesBytes = series.size() * sizeof(float);
+
+    std::cout << std::setw(10) << "workload" << std::setw(10) << "threads" << std::setw(10) << "ms" << std::setw(10)
+              << "GB/s" << std::setw(12) << "identical" << std::endl;
+
+    std::srand(1);
+    const double randMs = bestMs([&]()
+                                 {
+                                     for (size_t i = 0; i < points; i++)
+                                     {
+                                         xy[i * 2] = 2 * std::rand() / (float)RAND_MAX - 1;
+                                         xy[i * 2 + 1] = 2 * std::rand() / (float)RAND_MAX - 1;
+                                         values[i] = std::rand() % 256;
+                                     }
+                                 });
+    report("scatter", "rand", randMs, pointBytes, "-");
+
+    std::vector<float> referenceXy;
+    std::vector<uint8_t> referenceValues;
+    std::vector<float> referenceWalk;
+    int mismatches = 0;
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        const cppplot::Synth synth(1, threads);
+        const double scatterMs = bestMs([&]()
+                                        {
+                                            synth.uniformXy(xy.data(), points, -1, 1, -1, 1, 0);
+                                            synth.bytes(values.data(), points, 0, 255, 1);
+                                        });
+        if (referenceXy.empty())
+        {
+            referenceXy = xy;
+            referenceValues = values;
+        }
+        const bool scatterSame = xy == referenceXy && values == referenceValues;
+        report("scatter", std::to_string(threads), scatterMs, pointBytes, scatterSame ? "yes" : "NO");
+
+        const double sineMs = bestMs([&]()
+                                     { synth.sine(series.data(), samples, 0.001f, 0.0f, 0.5f, 0.05f, 2); });
+        report("sine", std::to_string(threads), sineMs, seriesBytes, "-");
+
+        const double walkMs = bestMs([&]()
+                                     { synth.randomWalk(series.data(), samples, 0.01f, 0.0f, 3); });
+        if (referenceWalk.empty())
+        {
+            referenceWalk = series;
+        }
+        const bool walkSame = series == referenceWalk;
+        report("walk", std::to_string(threads), walkMs, seriesBytes, walkSame ? "yes" : "NO");
+
+        mismatches += !scatterSame + !walkSame;
+        if (threads < maxThreads && threads * 2 > maxThreads)
+        {
+            threads = maxThreads / 2;
+        }
+    }
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,70 @@
+#include <chrono>
+#include <cppplot/profiler.h>
+#include <cppplot/trace.h>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Measures the cost of a trace scope when tracing is stopped and when it streams to a file, and of a
+// profiler stage scope, which also emits trace events while tracing.
+
+const int iterations = 2000000;
+
+std::chrono::high_resolution_clock timer;
+volatile int sink = 0;
+
+template <typename Body>
+double nsPerIteration(Body body)
+{
+    const auto start = timer.now();
+    for (int i = 0; i < iterations; i++)
+    {
+        body(i);
+    }
+    return std::chrono::duration<double, std::nano>(timer.now() - start).count() / iterations;
+}
+
+void report(const std::string &name, double ns)
+{
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << ns << " ns" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    const std::string path = argc > 1 ? argv[1] : "trace_overhead.json";
+    auto &trace = cppplot::TraceWriter::instance();
+    cppplot::FrameProfiler profiler;
+
+    const auto bare = nsPerIteration([](int i)
+                                     { sink = sink + i; });
+    const auto disabled = nsPerIteration([](int i)
+                                         {
+                                             CPPPLOT_TRACE_SCOPE("scope");
+                                             sink = sink + i; });
+    const auto stageDisabled = nsPerIteration([&profiler](int i)
+                                              {
+                                                  const auto stage = profiler.scope(cppplot::Stage::Draw);
+                                                  sink = sink + i; });
+
+    trace.start(path);
+    const auto enabled = nsPerIteration([](int i)
+                                        {
+                                            CPPPLOT_TRACE_SCOPE("scope");
+                                            sink = sink + i; });
+    const auto counter = nsPerIteration([](int i)
+                                        { CPPPLOT_TRACE_COUNTER("counter", i); });
+    const auto stageEnabled = nsPerIteration([&profiler](int i)
+                                             {
+                                                 const auto stage = profiler.scope(cppplot::Stage::Draw);
+                                                 sink = sink + i; });
+    trace.stop();
+
+    report("no instrumentation", bare);
+    report("trace scope, stopped", disabled - bare);
+    report("trace scope, running", enabled - bare);
+    report("trace counter, running", counter - bare);
+    report("profiler stage, stopped", stageDisabled - bare);
+    report("profiler stage, running", stageEnabled - bare);
+    std::cout << "dropped events: " << trace.dropped() << std::endl;
+}
@@ -0,0 +1,141 @@
+#ifndef CPPPLOT_AXIS_TRANSFORM_H
+#define CPPPLOT_AXIS_TRANSFORM_H
+
+#include "shader_variants.h"
+#include <GL/glew.h>
+#include <cmath>
+
+namespace cppplot
+{
+    enum class AxisScale
+    {
+        Linear,
+        Log10,
+        // log10 away from zero and linear within +-linearThreshold, defined for negative values
+        Symlog
+    };
+
+    // Maps data values on one axis to clip space: the scale is applied first, then [domainMin, domainMax]
+    // goes linearly to [rangeMin, rangeMax]. Zoom and pan only change the domain.
+    struct Axis
+    {
+        AxisScale scale = AxisScale::Linear;
+        float domainMin = -1.0f;
+        float domainMax = 1.0f;
+        float rangeMin = -1.0f;
+        float rangeMax = 1.0f;
+        float linearThreshold = 1.0f;
+
+        // Same formulas as the vertex shader, for hit testing and axis ticks on the CPU
+        [[nodiscard]] float scaled(float value) const
+        {
+            switch (scale)
+            {
+            case AxisScale::Log10:
+                return std::log10(std::fmax(value, 1e-30f));
+            case AxisScale::Symlog:
+                return std::copysign(std::log10(1.0f + std::fabs(value) / linearThreshold), value);
+            default:
+                return value;
+            }
+        }
+
+        [[nodiscard]] float unscaled(float value) const
+        {
+            switch (scale)
+            {
+            case AxisScale::Log10:
+                return std::pow(10.0f, value);
+            case AxisScale::Symlog:
+                return std::copysign((std::pow(10.0f, std::fabs(value)) - 1.0f) * linearThreshold, value);
+            default:
+                return value;
+            }
+        }
+
+        [[nodiscard]] float toClip(float value) const
+        {
+            const float lo = scaled(domainMin);
+            const float hi = scaled(domainMax);
+            return rangeMin + (scaled(value) - lo) / (hi - lo) * (rangeMax - rangeMin);
+        }
+
+        [[nodiscard]] float fromClip(float clip) const
+        {
+            const float lo = scaled(domainMin);
+            const float hi = scaled(domainMax);
+            return unscaled(lo + (clip - rangeMin) / (rangeMax - rangeMin) * (hi - lo));
+        }
+
+        // Scales the visible domain by factor around the data value at clip coordinate anchor
+        void zoom(float factor, float anchor)
+        {
+            const float lo = scaled(domainMin);
+            const float hi = scaled(domainMax);
+            const float center = lo + (anchor - rangeMin) / (rangeMax - rangeMin) * (hi - lo);
+            domainMin = unscaled(center + (lo - center) * factor);
+            domainMax = unscaled(center + (hi - center) * factor);
+        }
+
+        // Moves the visible domain by a distance given in clip coordinates
+        void pan(float clipDelta)
+        {
+            const float lo = scaled(domainMin);
+            const float hi = scaled(domainMax);
+            const float shift = clipDelta / (rangeMax - rangeMin) * (hi - lo);
+            domainMin = unscaled(lo - shift);
+            domainMax = unscaled(hi - shift);
+        }
+    };
+
+    // Shader feature evaluating an Axis for x and y in the vertex shader, so positions stay in data
+    // units and rescaling, zooming or panning only updates uniforms. The scale is a uniform branch, the
+    // same program serves every combination of axis scales.
+    struct AxisTransforms : feature::Base
+    {
+        static constexpr int stage = feature::Transform;
+        static constexpr const char *vertexDeclarations =
+            "uniform ivec2 uAxisScale;\n"
+            "uniform vec2 uAxisThreshold;\n"
+            "uniform vec4 uAxisDomain;\n"
+            "uniform vec4 uAxisRange;\n"
+            "float axisScaled(float v, int scale, float threshold)\n"
+            "{\n"
+            "    if (scale == 1) return log(max(v, 1e-30)) * 0.4342944819;\n"
+            "    if (scale == 2) return sign(v) * log(1.0 + abs(v) / threshold) * 0.4342944819;\n"
+            "    return v;\n"
+            "}\n";
+        static constexpr const char *vertexCode =
+            "    pos = vec2(axisScaled(pos.x, uAxisScale.x, uAxisThreshold.x), axisScaled(pos.y, uAxisScale.y, uAxisThreshold.y));\n"
+            "    pos = uAxisRange.xz + (pos - uAxisDomain.xz) / (uAxisDomain.yw - uAxisDomain.xz) * (uAxisRange.yw - uAxisRange.xz);\n";
+
+        class Uniforms
+        {
+        private:
+            GLint _scale = -1;
+            GLint _threshold = -1;
+            GLint _domain = -1;
+            GLint _range = -1;
+
+        public:
+            void locate(GLuint program)
+            {
+                _scale = glGetUniformLocation(program, "uAxisScale");
+                _threshold = glGetUniformLocation(program, "uAxisThreshold");
+                _domain = glGetUniformLocation(program, "uAxisDomain");
+                _range = glGetUniformLocation(program, "uAxisRange");
+            }
+
+            // Call with the program in use; the domains are passed already scaled
+            void setAxes(const Axis &x, const Axis &y) const
+            {
+                glUniform2i(_scale, static_cast<int>(x.scale), static_cast<int>(y.scale));
+                glUniform2f(_threshold, x.linearThreshold, y.linearThreshold);
+                glUniform4f(_domain, x.scaled(x.domainMin), x.scaled(x.domainMax), y.scaled(y.domainMin), y.scaled(y.domainMax));
+                glUniform4f(_range, x.rangeMin, x.rangeMax, y.rangeMin, y.rangeMax);
+            }
+        };
+    };
+}
+
+#endif
@@ -0,0 +1,246 @@
+#ifndef CPPPLOT_CANVAS_H
+#define CPPPLOT_CANVAS_H
+
+#include "offscreen.h"
+#include <GL/glew.h>
+#include <glfwpp/glfwpp.h>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace cppplot
+{
+    enum class Backend
+    {
+        Window,
+        Offscreen
+    };
+
+    // Drawing surface of a plot, selected at init: an on-screen glfw window, or an offscreen framebuffer
+    // backed by an EGL context (no display needed) or, where EGL is missing, by a hidden glfw window.
+    // Plots render the same way on both; offscreen frames are read back with readPixels(). A canvas
+    // created with a share canvas shares its GL objects (programs, buffers, textures but not VAOs or
+    // framebuffers) and must be destroyed before it.
+    class Canvas
+    {
+    private:
+        Backend _backend;
+        std::shared_ptr<glfw::GlfwLibrary> _library;
+        std::optional<glfw::Window> _window;
+#ifdef CPPPLOT_HAS_EGL
+        std::unique_ptr<OffscreenContext> _context;
+#endif
+        std::unique_ptr<Framebuffer> _framebuffer;
+        int _frameLimit;
+        int _frames = 0;
+
+        void createWindow(int width, int height, const std::string &title, bool visible, const Canvas *share)
+        {
+            if (share && share->_library)
+            {
+                _library = share->_library;
+            }
+            else
+            {
+                _library.reset(new glfw::GlfwLibrary(glfw::init()));
+            }
+
+            glfw::WindowHints hints;
+            hints.clientApi = glfw::ClientApi::OpenGl;
+            hints.contextVersionMajor = 4;
+            hints.contextVersionMinor = 6;
+            hints.visible = visible;
+            hints.apply();
+
+            _window.emplace(width, height, title.c_str(), nullptr, share && share->_window ? &*share->_window : nullptr);
+            glfw::makeContextCurrent(*_window);
+            glfw::swapInterval(visible ? 1 : 0);
+        }
+
+    public:
+        // frameLimit stops offscreen rendering after that many frames, 0 renders until the window closes
+        Canvas(int width, int height, const std::string &title, Backend backend = Backend::Window, int frameLimit = 0,
+               const Canvas *share = nullptr) :
+            _backend(backend), _frameLimit(frameLimit)
+        {
+            if (backend == Backend::Window)
+            {
+                createWindow(width, height, title, true, share);
+                if (glewInit() != GLEW_OK)
+                {
+                    throw std::runtime_error("Could not initialize GLEW");
+                }
+                return;
+            }
+
+#ifdef CPPPLOT_HAS_EGL
+            _context = std::make_unique<OffscreenContext>(4, 6, share ? share->_context.get() : nullptr);
+#else
+            createWindow(width, height, title, false, share);
+#endif
+            glewExperimental = GL_TRUE;
+            const auto status = glewInit();
+            // a GLX build of GLEW reports the missing X display but has loaded the GL entry points
+            if (status != GLEW_OK && status != GLEW_ERROR_NO_GLX_DISPLAY)
+            {
+                throw std::runtime_error("Could not initialize GLEW");
+            }
+            _framebuffer = std::make_unique<Framebuffer>(width, height);
+        }
+
+        Canvas(const Canvas &) = delete;
+        Canvas &operator=(const Canvas &) = delete;
+
+        // The framebuffer is deleted in its own context; if that cannot be made current it is left to go
+        // with the context
+        ~Canvas()
+        {
+            try
+            {
+                makeCurrent();
+            }
+            catch (...)
+            {
+                _framebuffer.release();
+            }
+            _framebuffer.reset();
+        }
+
+        // Makes this canvas the GL target of the calling thread, needed when rendering several canvases
+        void makeCurrent()
+        {
+#ifdef CPPPLOT_HAS_EGL
+            if (_context)
+            {
+                _context->makeCurrent();
+            }
+#endif
+            if (_window)
+            {
+                glfw::makeContextCurrent(*_window);
+            }
+            if (_framebuffer)
+            {
+                _framebuffer->bind();
+            }
+        }
+
+        // Whether present() waits for the vertical blank, on by default for windows. With several windows
+        // only the last one presented per frame should wait, or each swap waits for its own blank.
+        // Offscreen canvases never wait.
+        void setVsync(bool on)
+        {
+            if (_backend == Backend::Window)
+            {
+                glfw::makeContextCurrent(*_window);
+                glfw::swapInterval(on ? 1 : 0);
+            }
+        }
+
+        [[nodiscard]] Backend backend() const
+        {
+            return _backend;
+        }
+
+        // The on-screen window, nullptr when rendering offscreen
+        [[nodiscard]] glfw::Window *window()
+        {
+            return _backend == Backend::Window ? &*_window : nullptr;
+        }
+
+        // The offscreen render target, nullptr for the on-screen window
+        [[nodiscard]] Framebuffer *framebuffer()
+        {
+            return _framebuffer.get();
+        }
+
+        [[nodiscard]] bool shouldClose() const
+        {
+            if (_backend == Backend::Window)
+            {
+                return _window->shouldClose();
+            }
+            return _frameLimit > 0 && _frames >= _frameLimit;
+        }
+
+        void pollEvents()
+        {
+            if (_library)
+            {
+                glfw::pollEvents();
+            }
+        }
+
+        void present()
+        {
+            if (_backend == Backend::Window)
+            {
+                _window->swapBuffers();
+            }
+            _frames++;
+        }
+
+        // Seconds since start, offscreen time advances a fixed 1/60 s per frame so output is reproducible
+        [[nodiscard]] double time() const
+        {
+            if (_backend == Backend::Window)
+            {
+                return glfw::getTime();
+            }
+            return _frames / 60.0;
+        }
+
+        [[nodiscard]] int frames() const
+        {
+            return _frames;
+        }
+
+        [[nodiscard]] std::tuple<int, int> getSize() const
+        {
+            if (_framebuffer)
+            {
+                return {_framebuffer->width(), _framebuffer->height()};
+            }
+            return _window->getFramebufferSize();
+        }
+
+        // Current frame as RGBA8, top row first
+        [[nodiscard]] std::vector<uint8_t> readPixels() const
+        {
+            if (_framebuffer)
+            {
+                return _framebuffer->readPixels();
+            }
+
+            const auto [width, height] = getSize();
+            std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            flipRows(pixels, width, height);
+            return pixels;
+        }
+    };
+
+    // Demo command line: "--headless [frames]" anywhere in the arguments renders offscreen for the given
+    // number of frames, defaultFrames when no positive count follows
+    inline Backend backendFromArgs(int argc, char **argv, int &frames, int defaultFrames = 300)
+    {
+        frames = 0;
+        for (int i = 1; i < argc; i++)
+        {
+            if (std::string(argv[i]) == "--headless")
+            {
+                frames = i + 1 < argc && std::atoi(argv[i + 1]) > 0 ? std::atoi(argv[i + 1]) : defaultFrames;
+                return Backend::Offscreen;
+            }
+        }
+        return Backend::Window;
+    }
+}
+
+#endif
@@ -0,0 +1,247 @@
+#ifndef CPPPLOT_CAPTURE_H
+#define CPPPLOT_CAPTURE_H
+
+#include <GL/glew.h>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cppplot
+{
+    struct CapturedFrame
+    {
+        uint64_t index;
+        int width;
+        int height;
+        // RGBA8, top row first
+        std::vector<uint8_t> rgba;
+    };
+
+    // Records rendered frames without stalling the pipeline. capture() starts an asynchronous
+    // glReadPixels into the next pixel buffer object of a ring and fences it; the PBO is mapped one or two
+    // frames later, once its fence has signalled, and the pixels are passed to the callback on a worker
+    // thread. If a PBO is still in flight when its turn comes again, or the worker is behind by more than
+    // maxQueued frames, the frame is dropped rather than waited for.
+    class FrameCapture
+    {
+    public:
+        using Callback = std::function<void(const CapturedFrame &)>;
+
+    private:
+        struct Slot
+        {
+            GLuint pbo = 0;
+            GLsync fence = nullptr;
+            uint64_t index = 0;
+        };
+
+        int _width;
+        int _height;
+        size_t _bytes;
+        Callback _callback;
+        size_t _maxQueued;
+
+        std::vector<Slot> _slots;
+        size_t _next = 0;
+        uint64_t _frame = 0;
+        size_t _dropped = 0;
+
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        std::condition_variable _idle;
+        std::deque<CapturedFrame> _queue;
+        std::vector<std::vector<uint8_t>> _freeBuffers;
+        bool _busy = false;
+        bool _stopping = false;
+        std::thread _worker;
+
+        std::vector<uint8_t> takeBuffer()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_freeBuffers.empty())
+            {
+                return std::vector<uint8_t>(_bytes);
+            }
+            auto buffer = std::move(_freeBuffers.back());
+            _freeBuffers.pop_back();
+            return buffer;
+        }
+
+        // Maps a completed slot and hands its pixels to the worker
+        void retire(Slot &slot)
+        {
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (_queue.size() >= _maxQueued)
+                {
+                    _dropped++;
+                    return;
+                }
+            }
+
+            CapturedFrame frame = {slot.index, _width, _height, takeBuffer()};
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+            const void *mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, _bytes, GL_MAP_READ_BIT);
+            if (mapped)
+            {
+                std::memcpy(frame.rgba.data(), mapped, _bytes);
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            _queue.push_back(std::move(frame));
+            _wake.notify_one();
+        }
+
+        void workerLoop()
+        {
+            const size_t rowBytes = static_cast<size_t>(_width) * 4;
+            std::vector<uint8_t> row(rowBytes);
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (true)
+            {
+                _wake.wait(lock, [this]
+                           { return !_queue.empty() || _stopping; });
+                if (_queue.empty())
+                {
+                    return;
+                }
+
+                CapturedFrame frame = std::move(_queue.front());
+                _queue.pop_front();
+                _busy = true;
+                lock.unlock();
+
+                // GL rows start at the bottom
+                for (int y = 0; y < _height / 2; y++)
+                {
+                    uint8_t *top = frame.rgba.data() + y * rowBytes;
+                    uint8_t *bottom = frame.rgba.data() + (_height - 1 - y) * rowBytes;
+                    std::memcpy(row.data(), top, rowBytes);
+                    std::memcpy(top, bottom, rowBytes);
+                    std::memcpy(bottom, row.data(), rowBytes);
+                }
+                _callback(frame);
+
+                lock.lock();
+                _freeBuffers.push_back(std::move(frame.rgba));
+                _busy = false;
+                _idle.notify_all();
+            }
+        }
+
+    public:
+        FrameCapture(int width, int height, Callback callback, size_t ringSize = 3, size_t maxQueued = 8) :
+            _width(width), _height(height), _bytes(static_cast<size_t>(width) * height * 4),
+            _callback(std::move(callback)), _maxQueued(maxQueued), _slots(ringSize < 2 ? 2 : ringSize)
+        {
+            for (auto &slot : _slots)
+            {
+                glGenBuffers(1, &slot.pbo);
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+                glBufferData(GL_PIXEL_PACK_BUFFER, _bytes, nullptr, GL_STREAM_READ);
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            _worker = std::thread(&FrameCapture::workerLoop, this);
+        }
+
+        FrameCapture(const FrameCapture &) = delete;
+        FrameCapture &operator=(const FrameCapture &) = delete;
+
+        // Needs the GL context to be current, finishes the frames in flight first
+        ~FrameCapture()
+        {
+            finish();
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stopping = true;
+                _wake.notify_one();
+            }
+            _worker.join();
+
+            for (auto &slot : _slots)
+            {
+                glDeleteBuffers(1, &slot.pbo);
+            }
+        }
+
+        // Hands over frames whose readback has completed, never waits on the GPU
+        void poll()
+        {
+            for (size_t i = 0; i < _slots.size(); i++)
+            {
+                Slot &slot = _slots[(_next + i) % _slots.size()];
+                if (slot.fence && glClientWaitSync(slot.fence, 0, 0) != GL_TIMEOUT_EXPIRED)
+                {
+                    retire(slot);
+                }
+            }
+        }
+
+        // Queues the readback of the current frame from framebuffer, call after drawing and before swapping
+        void capture(GLuint framebuffer = 0)
+        {
+            poll();
+
+            Slot &slot = _slots[_next];
+            const uint64_t index = _frame++;
+            if (slot.fence)
+            {
+                _dropped++;
+                return;
+            }
+
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            glReadPixels(0, 0, _width, _height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+            slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            glFlush();
+            slot.index = index;
+            _next = (_next + 1) % _slots.size();
+        }
+
+        // Blocks until every queued readback has been delivered to the callback
+        void finish()
+        {
+            for (size_t i = 0; i < _slots.size(); i++)
+            {
+                Slot &slot = _slots[(_next + i) % _slots.size()];
+                if (slot.fence)
+                {
+                    glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+                    retire(slot);
+                }
+            }
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            _idle.wait(lock, [this]
+                       { return _queue.empty() && !_busy; });
+        }
+
+        // Frames skipped because the GPU or the callback could not keep up
+        [[nodiscard]] size_t dropped() const
+        {
+            return _dropped;
+        }
+
+        [[nodiscard]] uint64_t frames() const
+        {
+            return _frame;
+        }
+    };
+}
+
+#endif
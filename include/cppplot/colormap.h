@@ -0,0 +1,152 @@
+#ifndef CPPPLOT_COLORMAP_H
+#define CPPPLOT_COLORMAP_H
+
+#include "resource_pool.h"
+#include "shader_variants.h"
+#include <GL/glew.h>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace cppplot
+{
+    enum class Colormap
+    {
+        Viridis,
+        Magma,
+        Inferno,
+        Plasma,
+        Count
+    };
+
+    inline const char *colormapName(Colormap map)
+    {
+        switch (map)
+        {
+        case Colormap::Magma:
+            return "magma";
+        case Colormap::Inferno:
+            return "inferno";
+        case Colormap::Plasma:
+            return "plasma";
+        default:
+            return "viridis";
+        }
+    }
+
+    // size RGB texels sampled from a degree 6 polynomial fit of the matplotlib colormap, within about 2%
+    // of the reference tables
+    inline std::vector<uint8_t> colormapTexels(Colormap map, int size = 256)
+    {
+        static const float fits[4][7][3] = {
+            {{0.2777273272f, 0.0054073445f, 0.3340998053f},
+             {0.1050930431f, 1.4046135299f, 1.3845901626f},
+             {-0.3308618287f, 0.2148475595f, 0.0950951630f},
+             {-4.6342304990f, -5.7991009734f, -19.3324409563f},
+             {6.2282699363f, 14.1799333668f, 56.6905526007f},
+             {4.7763849977f, -13.7451453777f, -65.3530326334f},
+             {-5.4354558559f, 4.6458526122f, 26.3124352496f}},
+            {{-0.0021364851f, -0.0007496551f, -0.0053861279f},
+             {0.2516605407f, 0.6775232437f, 2.4940265993f},
+             {8.3537172792f, -3.5777195150f, 0.3144679030f},
+             {-27.6687330858f, 14.2647307810f, -13.6492131881f},
+             {52.1761398123f, -27.9436060717f, 12.9441694424f},
+             {-50.7685253647f, 29.0465828213f, 4.2341529938f},
+             {18.6557050659f, -11.4897735120f, -5.6019615087f}},
+            {{0.0002189404f, 0.0016510046f, -0.0194808984f},
+             {0.1065134195f, 0.5639564368f, 3.9327123889f},
+             {11.6024930825f, -3.9728539657f, -15.9423941063f},
+             {-41.7039961314f, 17.4363988821f, 44.3541451987f},
+             {77.1629356994f, -33.4023589421f, -81.8073092574f},
+             {-71.3194282450f, 32.6260642640f, 73.2095198580f},
+             {25.1311262248f, -12.2426689524f, -23.0703250029f}},
+            {{0.0587323439f, 0.0233367089f, 0.5433401827f},
+             {2.1765146342f, 0.2383834171f, 0.7539604600f},
+             {-2.6894604765f, -7.4558511357f, 3.1107999397f},
+             {6.1303483459f, 42.3461881477f, -28.5188546533f},
+             {-11.1074361906f, -82.6663110943f, 60.1398476742f},
+             {10.0230655765f, 71.4136177010f, -54.0721865556f},
+             {-3.6587138428f, -22.9315346546f, 18.1919077854f}}};
+        const auto &fit = fits[static_cast<int>(map) % 4];
+
+        std::vector<uint8_t> rgb(static_cast<size_t>(size) * 3);
+        for (int i = 0; i < size; i++)
+        {
+            const float t = size > 1 ? static_cast<float>(i) / (size - 1) : 0.0f;
+            for (int c = 0; c < 3; c++)
+            {
+                float value = fit[6][c];
+                for (int k = 5; k >= 0; k--)
+                {
+                    value = value * t + fit[k][c];
+                }
+                rgb[i * 3 + c] = static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+            }
+        }
+        return rgb;
+    }
+
+    // The colormap's lookup texture in the pool, created on first use and shared by every canvas of the group
+    inline GLuint colormapTexture(ResourcePool &pool, Colormap map, int size = 256)
+    {
+        const auto name = std::string("colormap ") + colormapName(map) + " " + std::to_string(size);
+        return pool.texture1D(name, colormapTexels(map, size).data(), size);
+    }
+
+    // Colour from one scalar per vertex (per point for instanced shapes) looked up in a 1D colormap texture,
+    // a third of the memory of SeriesColor with uint8 values. Recolouring only changes the texture or the
+    // range uniform, the values are never uploaded again. Integer values are normalized, so the range is
+    // given in the units of Value and converted.
+    template <typename Value = uint16_t>
+    struct ScalarColor : feature::Base
+    {
+        static_assert(std::is_same_v<Value, uint8_t> || std::is_same_v<Value, uint16_t> || std::is_same_v<Value, float>,
+                      "scalar colour values are uint8_t, uint16_t or float");
+
+        static constexpr unsigned flags = feature::ScalarValue;
+        static constexpr GLenum valueType = std::is_same_v<Value, float>      ? GL_FLOAT
+                                            : std::is_same_v<Value, uint16_t> ? GL_UNSIGNED_SHORT
+                                                                              : GL_UNSIGNED_BYTE;
+        static constexpr const char *vertexDeclarations =
+            "layout (location = 2) in float aValue;\nuniform sampler1D uColormap;\nuniform vec2 uColorRange;\n";
+        // texel centres at both ends, so the range maps onto the whole table
+        static constexpr const char *colorCode =
+            "    float texels = float(textureSize(uColormap, 0));\n"
+            "    float colorT = clamp((aValue - uColorRange.x) / (uColorRange.y - uColorRange.x), 0.0, 1.0);\n"
+            "    vColor = texture(uColormap, (0.5 + colorT * (texels - 1.0)) / texels).rgb;\n";
+
+        class Uniforms
+        {
+        private:
+            GLint _colormap = -1;
+            GLint _range = -1;
+
+        public:
+            void locate(GLuint program)
+            {
+                _colormap = glGetUniformLocation(program, "uColormap");
+                _range = glGetUniformLocation(program, "uColorRange");
+            }
+
+            // Call with the program in use; binds texture to the texture unit
+            void setColormap(GLuint texture, GLint unit = 0) const
+            {
+                glActiveTexture(GL_TEXTURE0 + unit);
+                glBindTexture(GL_TEXTURE_1D, texture);
+                glUniform1i(_colormap, unit);
+            }
+
+            // values at and below min take the first colour, at and above max the last
+            void setColorRange(float min, float max) const
+            {
+                const float scale = std::is_same_v<Value, float> ? 1.0f : 1.0f / std::numeric_limits<Value>::max();
+                glUniform2f(_range, min * scale, max * scale);
+            }
+        };
+    };
+}
+
+#endif
@@ -0,0 +1,369 @@
+#ifndef CPPPLOT_CSV_READER_H
+#define CPPPLOT_CSV_READER_H
+
+#include "parallel.h"
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CPPPLOT_CSV_SSE2 1
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace cppplot
+{
+    struct CsvOptions
+    {
+        char delimiter = ',';
+        // the first line names the columns
+        bool header = true;
+        // bytes read per chunk, one block of rows is delivered per chunk
+        size_t chunkBytes = 32 << 20;
+        // the first chunk is smaller, so the first block can be plotted right away
+        size_t firstChunkBytes = 1 << 20;
+        // threads parsing a chunk, 0 uses every hardware thread
+        size_t threads = 0;
+    };
+
+    // The rows parsed from one chunk, one float vector per column in file order. Missing and non-numeric
+    // fields are NaN.
+    struct CsvBlock
+    {
+        static constexpr size_t rowIndex = std::numeric_limits<size_t>::max();
+
+        // row number of the first row of the block, counted from the first data row of the file
+        size_t firstRow = 0;
+        size_t rows = 0;
+        std::vector<std::vector<float>> columns;
+
+        // Interleaved x, y vertices for the line vertex buffers, y from yColumn and x from xColumn, or the
+        // row number with rowIndex. Writes rows vertices.
+        void toXy(float *xy, size_t yColumn, size_t xColumn = rowIndex) const
+        {
+            const auto &y = columns.at(yColumn);
+            for (size_t i = 0; i < rows; i++)
+            {
+                xy[i * 2] = xColumn == rowIndex ? static_cast<float>(firstRow + i) : columns[xColumn][i];
+                xy[i * 2 + 1] = y[i];
+            }
+        }
+    };
+
+    // Streaming reader of numeric CSV logs (no quoted fields). The file is read in chunks, the next chunk
+    // being read while the current one is parsed; each chunk is split at line ends into one piece per
+    // thread and parsed in two passes, counting the rows of every piece and then parsing each piece
+    // straight into its rows of the block. Delimiters and line ends are found 16 bytes at a time with
+    // SSE2 and fields are converted with std::from_chars. Blocks are handed to the caller in file order as
+    // soon as their chunk is parsed, so a plot can show the start of a file while the rest still loads.
+    class CsvReader
+    {
+    private:
+        CsvOptions _options;
+        size_t _threads;
+        std::vector<std::string> _names;
+        size_t _columns = 0;
+
+        static unsigned lowestBit(unsigned mask)
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+        }
+
+        // fn(p) for every p in [begin, end) holding a or b, in order
+        template <typename Fn>
+        static void scan(const char *begin, const char *end, char a, char b, Fn fn)
+        {
+            const char *p = begin;
+#ifdef CPPPLOT_CSV_SSE2
+            const __m128i va = _mm_set1_epi8(a);
+            const __m128i vb = _mm_set1_epi8(b);
+            for (; p + 16 <= end; p += 16)
+            {
+                const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+                auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(bytes, va), _mm_cmpeq_epi8(bytes, vb))));
+                while (mask)
+                {
+                    fn(p + lowestBit(mask));
+                    mask &= mask - 1;
+                }
+            }
+#endif
+            for (; p < end; p++)
+            {
+                if (*p == a || *p == b)
+                {
+                    fn(p);
+                }
+            }
+        }
+
+        // blank lines, possibly with a \r, make no row
+        static bool blank(const char *begin, const char *end)
+        {
+            return end == begin || (end == begin + 1 && *begin == '\r');
+        }
+
+        static float parseField(const char *begin, const char *end)
+        {
+            while (begin < end && (*begin == ' ' || *begin == '\t' || *begin == '+'))
+            {
+                begin++;
+            }
+            while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r'))
+            {
+                end--;
+            }
+            float value;
+            const auto result = std::from_chars(begin, end, value);
+            return result.ec == std::errc() && result.ptr == end ? value : std::numeric_limits<float>::quiet_NaN();
+        }
+
+        // Non-blank lines of [begin, end), which ends with a line end
+        size_t countRows(const char *begin, const char *end) const
+        {
+            size_t rows = 0;
+            const char *line = begin;
+            scan(begin, end, '\n', '\n', [&](const char *p)
+                 {
+                     rows += !blank(line, p);
+                     line = p + 1;
+                 });
+            return rows;
+        }
+
+        // Parses the lines of [begin, end) into rows [row, ...) of the block
+        void parseRows(const char *begin, const char *end, CsvBlock &block, size_t row) const
+        {
+            const float nan = std::numeric_limits<float>::quiet_NaN();
+            const char *line = begin;
+            const char *field = begin;
+            size_t column = 0;
+            scan(begin, end, _options.delimiter, '\n', [&](const char *p)
+                 {
+                     if (*p != '\n')
+                     {
+                         if (column < _columns)
+                         {
+                             block.columns[column][row] = parseField(field, p);
+                         }
+                         column++;
+                         field = p + 1;
+                         return;
+                     }
+                     if (!blank(line, p))
+                     {
+                         if (column < _columns)
+                         {
+                             block.columns[column++][row] = parseField(field, p);
+                         }
+                         for (; column < _columns; column++)
+                         {
+                             block.columns[column][row] = nan;
+                         }
+                         row++;
+                     }
+                     line = p + 1;
+                     field = p + 1;
+                     column = 0;
+                 });
+        }
+
+        // Parses [begin, end), which ends with a line end, into block
+        void parseChunk(const char *begin, const char *end, CsvBlock &block) const
+        {
+            const size_t bytes = static_cast<size_t>(end - begin);
+            const size_t pieces = std::max<size_t>(1, std::min(_threads, bytes / (64 << 10)));
+
+            // piece boundaries just after a line end
+            std::vector<const char *> bounds(pieces + 1, end);
+            bounds[0] = begin;
+            for (size_t t = 1; t < pieces; t++)
+            {
+                const char *from = std::max(bounds[t - 1], begin + bytes * t / pieces);
+                const auto *newline = static_cast<const char *>(std::memchr(from, '\n', static_cast<size_t>(end - from)));
+                bounds[t] = newline ? newline + 1 : end;
+            }
+
+            std::vector<size_t> rows(pieces + 1, 0);
+            parallelFor(pieces, pieces, [&](size_t, size_t first, size_t last)
+                        {
+                            for (size_t t = first; t < last; t++)
+                            {
+                                rows[t + 1] = countRows(bounds[t], bounds[t + 1]);
+                            }
+                        });
+            for (size_t t = 0; t < pieces; t++)
+            {
+                rows[t + 1] += rows[t];
+            }
+
+            block.rows = rows[pieces];
+            block.columns.resize(_columns);
+            for (auto &column : block.columns)
+            {
+                column.resize(block.rows);
+            }
+            parallelFor(pieces, pieces, [&](size_t, size_t first, size_t last)
+                        {
+                            for (size_t t = first; t < last; t++)
+                            {
+                                parseRows(bounds[t], bounds[t + 1], block, rows[t]);
+                            }
+                        });
+        }
+
+        // Column names (or numbers without a header) from the first line
+        void readFirstLine(const char *begin, const char *end)
+        {
+            _names.clear();
+            const char *field = begin;
+            const auto addName = [&](const char *fieldEnd)
+            {
+                std::string name(field, fieldEnd);
+                const auto first = name.find_first_not_of(" \t\r\"");
+                const auto last = name.find_last_not_of(" \t\r\"");
+                _names.push_back(first == std::string::npos ? "" : name.substr(first, last - first + 1));
+                field = fieldEnd + 1;
+            };
+            scan(begin, end, _options.delimiter, _options.delimiter, addName);
+            addName(end);
+            _columns = _names.size();
+            if (!_options.header)
+            {
+                for (size_t c = 0; c < _columns; c++)
+                {
+                    _names[c] = std::to_string(c);
+                }
+            }
+        }
+
+    public:
+        explicit CsvReader(CsvOptions options = {}) :
+            _options(options), _threads(options.threads ? options.threads : hardwareThreads())
+        {
+        }
+
+        // Column names, known once read() has delivered the first block
+        [[nodiscard]] const std::vector<std::string> &names() const
+        {
+            return _names;
+        }
+
+        [[nodiscard]] size_t columnCount() const
+        {
+            return _columns;
+        }
+
+        // Parses the file at path, calling onBlock(const CsvBlock &) on the calling thread for each chunk in
+        // file order. The block is reused for the next chunk, copy what must be kept. Returns the number of
+        // rows; throws std::runtime_error when the file cannot be read.
+        template <typename Fn>
+        size_t read(const std::string &path, Fn onBlock)
+        {
+            std::FILE *file = std::fopen(path.c_str(), "rb");
+            if (!file)
+            {
+                throw std::runtime_error("Could not open " + path);
+            }
+
+            std::vector<char> current(std::max<size_t>(1, std::min(_options.firstChunkBytes, _options.chunkBytes)));
+            std::vector<char> next;
+            size_t filled = std::fread(current.data(), 1, current.size(), file);
+            bool eof = filled < current.size();
+            bool firstLine = true;
+            CsvBlock block;
+            size_t totalRows = 0;
+
+            while (filled > 0)
+            {
+                // a chunk ends after its last line end, the rest goes to the next; at the end of the file the
+                // last line may have none
+                if (eof && current[filled - 1] != '\n')
+                {
+                    current.resize(std::max(current.size(), filled + 1));
+                    current[filled++] = '\n';
+                }
+                size_t used = filled;
+                while (used > 0 && current[used - 1] != '\n')
+                {
+                    used--;
+                }
+
+                const size_t carry = filled - used;
+                next.resize(carry + std::max({_options.chunkBytes, carry, size_t(1)}));
+                std::memcpy(next.data(), current.data() + used, carry);
+                size_t nextRead = 0;
+                std::thread reader;
+                if (!eof)
+                {
+                    reader = std::thread([&]
+                                         { nextRead = std::fread(next.data() + carry, 1, next.size() - carry, file); });
+                }
+
+                try
+                {
+                    const char *begin = current.data();
+                    const char *end = current.data() + used;
+                    if (firstLine && begin < end)
+                    {
+                        const auto *newline = static_cast<const char *>(std::memchr(begin, '\n', used));
+                        readFirstLine(begin, newline > begin && newline[-1] == '\r' ? newline - 1 : newline);
+                        if (_options.header)
+                        {
+                            begin = newline + 1;
+                        }
+                        firstLine = false;
+                    }
+                    if (begin < end)
+                    {
+                        block.firstRow = totalRows;
+                        parseChunk(begin, end, block);
+                        totalRows += block.rows;
+                        if (block.rows)
+                        {
+                            onBlock(static_cast<const CsvBlock &>(block));
+                        }
+                    }
+                }
+                catch (...)
+                {
+                    if (reader.joinable())
+                    {
+                        reader.join();
+                    }
+                    std::fclose(file);
+                    throw;
+                }
+
+                if (reader.joinable())
+                {
+                    reader.join();
+                }
+                eof = eof || nextRead < next.size() - carry;
+                filled = carry + nextRead;
+                std::swap(current, next);
+            }
+            std::fclose(file);
+            return totalRows;
+        }
+    };
+}
+
+#endif
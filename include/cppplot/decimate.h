@@ -0,0 +1,45 @@
+#ifndef CPPPLOT_DECIMATE_H
+#define CPPPLOT_DECIMATE_H
+
+#include <algorithm>
+#include <cstddef>
+
+namespace cppplot
+{
+    // Min/max decimation of a line of count xy samples in x order into columns buckets of consecutive
+    // samples, one per pixel column of the plot. Each bucket keeps its lowest and highest sample in their
+    // original order, so the decimated strip touches the same pixels as the full line with 2 vertices per
+    // column. Writes the vertices to out (room for 2 * columns) and returns their number; lines with no
+    // more than 2 * columns samples are copied unchanged.
+    inline size_t decimateMinMax(const float *xy, size_t count, size_t columns, float *out)
+    {
+        if (count <= 2 * columns)
+        {
+            std::copy(xy, xy + count * 2, out);
+            return count;
+        }
+
+        size_t written = 0;
+        for (size_t c = 0; c < columns; c++)
+        {
+            const size_t begin = c * count / columns;
+            const size_t end = (c + 1) * count / columns;
+            size_t low = begin;
+            size_t high = begin;
+            for (size_t i = begin + 1; i < end; i++)
+            {
+                low = xy[i * 2 + 1] < xy[low * 2 + 1] ? i : low;
+                high = xy[i * 2 + 1] > xy[high * 2 + 1] ? i : high;
+            }
+            for (const size_t i : {std::min(low, high), std::max(low, high)})
+            {
+                out[written * 2] = xy[i * 2];
+                out[written * 2 + 1] = xy[i * 2 + 1];
+                written++;
+            }
+        }
+        return written;
+    }
+}
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef CPPPLOT_DIRTY_H
+#define CPPPLOT_DIRTY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <vector>
+
+namespace cppplot
+{
+    // Half-open [begin, end) range
+    struct Range
+    {
+        size_t begin;
+        size_t end;
+    };
+
+    // Merged set of dirty [begin, end) element ranges of a single series
+    class DirtyIntervals
+    {
+    private:
+        std::map<size_t, size_t> _ranges;
+
+    public:
+        void mark(size_t begin, size_t end)
+        {
+            if (begin >= end)
+            {
+                return;
+            }
+
+            auto it = _ranges.upper_bound(begin);
+            if (it != _ranges.begin())
+            {
+                const auto prev = std::prev(it);
+                if (prev->second >= begin)
+                {
+                    begin = prev->first;
+                    end = std::max(end, prev->second);
+                    it = _ranges.erase(prev);
+                }
+            }
+
+            while (it != _ranges.end() && it->first <= end)
+            {
+                end = std::max(end, it->second);
+                it = _ranges.erase(it);
+            }
+
+            _ranges.emplace_hint(it, begin, end);
+        }
+
+        void markAll(size_t size)
+        {
+            _ranges.clear();
+            mark(0, size);
+        }
+
+        void clear()
+        {
+            _ranges.clear();
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return _ranges.empty();
+        }
+
+        // Total number of dirty elements
+        [[nodiscard]] size_t count() const
+        {
+            size_t total = 0;
+            for (const auto &[begin, end] : _ranges)
+            {
+                total += end - begin;
+            }
+            return total;
+        }
+
+        [[nodiscard]] const std::map<size_t, size_t> &ranges() const
+        {
+            return _ranges;
+        }
+    };
+
+    // Flattens the dirty intervals of series laid out back to back (seriesStride elements apart) into
+    // sorted buffer byte ranges. Ranges separated by at most mergeGapBytes are coalesced into one, trading
+    // a few redundant bytes for fewer upload calls.
+    inline std::vector<Range> collectUploadRanges(const std::vector<DirtyIntervals> &series, size_t seriesStride,
+                                                  size_t elementBytes, size_t mergeGapBytes = 0)
+    {
+        std::vector<Range> out;
+
+        for (size_t i = 0; i < series.size(); i++)
+        {
+            const size_t base = i * seriesStride;
+            for (const auto &[begin, end] : series[i].ranges())
+            {
+                const Range bytes = {(base + begin) * elementBytes, (base + end) * elementBytes};
+                if (!out.empty() && bytes.begin <= out.back().end + mergeGapBytes)
+                {
+                    out.back().end = std::max(out.back().end, bytes.end);
+                }
+                else
+                {
+                    out.push_back(bytes);
+                }
+            }
+        }
+
+        return out;
+    }
+
+    inline size_t totalBytes(const std::vector<Range> &ranges)
+    {
+        size_t total = 0;
+        for (const auto &r : ranges)
+        {
+            total += r.end - r.begin;
+        }
+        return total;
+    }
+}
+
+#endif
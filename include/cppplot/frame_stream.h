@@ -0,0 +1,287 @@
+#ifndef CPPPLOT_FRAME_STREAM_H
+#define CPPPLOT_FRAME_STREAM_H
+
+#include "image_export.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace cppplot
+{
+    // Delta-encodes rendered frames for a remote front-end such as a Jupyter notebook. The frame is cut
+    // into square tiles which are hashed; only tiles whose hash changed since they were last sent are
+    // encoded, horizontal runs of changed tiles being merged into one rectangle with a QOI payload. Each
+    // message is limited to frameBudget bytes of payload; tiles over budget stay pending and go first in
+    // the next message, so a static plot converges to a full image and then costs only a header per frame.
+    //
+    // Message layout (little endian):
+    //   "CPFS" u32 frame, u16 width, u16 height, u16 rectCount, u16 pendingTiles
+    //   rectCount x { u16 x, u16 y, u16 w, u16 h, u32 bytes, QOI payload }
+    class FrameStreamer
+    {
+    public:
+        static constexpr size_t maxRunTiles = 4;
+
+    private:
+        int _width;
+        int _height;
+        int _tileSize;
+        size_t _frameBudget;
+        int _tilesX;
+        int _tilesY;
+        uint32_t _frame = 0;
+        std::vector<uint64_t> _sentHashes;
+        std::vector<uint8_t> _sent;
+        // frame at which a tile became dirty and was not sent yet, 0 when clean
+        std::vector<uint32_t> _pendingSince;
+        std::vector<uint8_t> _tilePixels;
+
+        static void put16(std::vector<uint8_t> &out, uint32_t value)
+        {
+            out.push_back(value & 0xff);
+            out.push_back((value >> 8) & 0xff);
+        }
+
+        static void put32(std::vector<uint8_t> &out, uint32_t value)
+        {
+            put16(out, value & 0xffff);
+            put16(out, value >> 16);
+        }
+
+        uint64_t hashTile(const uint8_t *rgba, int tx, int ty) const
+        {
+            const int x0 = tx * _tileSize;
+            const int y0 = ty * _tileSize;
+            const int w = std::min(_tileSize, _width - x0);
+            const int h = std::min(_tileSize, _height - y0);
+            const size_t rowBytes = static_cast<size_t>(w) * 4;
+
+            uint64_t hash = 0x9e3779b97f4a7c15ull;
+            for (int y = y0; y < y0 + h; y++)
+            {
+                const uint8_t *row = rgba + (static_cast<size_t>(y) * _width + x0) * 4;
+                size_t i = 0;
+                for (; i + 8 <= rowBytes; i += 8)
+                {
+                    uint64_t word;
+                    std::memcpy(&word, row + i, 8);
+                    hash = (hash ^ word) * 0x100000001b3ull;
+                    hash ^= hash >> 29;
+                }
+                for (; i < rowBytes; i++)
+                {
+                    hash = (hash ^ row[i]) * 0x100000001b3ull;
+                }
+            }
+            return hash;
+        }
+
+        void appendRect(std::vector<uint8_t> &out, const uint8_t *rgba, int x, int y, int w, int h)
+        {
+            _tilePixels.resize(static_cast<size_t>(w) * h * 4);
+            for (int row = 0; row < h; row++)
+            {
+                std::memcpy(_tilePixels.data() + static_cast<size_t>(row) * w * 4,
+                            rgba + (static_cast<size_t>(y + row) * _width + x) * 4, static_cast<size_t>(w) * 4);
+            }
+            const auto payload = encodeQoi(_tilePixels.data(), w, h);
+
+            put16(out, x);
+            put16(out, y);
+            put16(out, w);
+            put16(out, h);
+            put32(out, static_cast<uint32_t>(payload.size()));
+            out.insert(out.end(), payload.begin(), payload.end());
+        }
+
+    public:
+        // frameBudget is the payload limit per message in bytes, 0 for unlimited
+        FrameStreamer(int width, int height, int tileSize = 64, size_t frameBudget = 0) :
+            _width(width), _height(height), _tileSize(tileSize), _frameBudget(frameBudget),
+            _tilesX((width + tileSize - 1) / tileSize), _tilesY((height + tileSize - 1) / tileSize),
+            _sentHashes(_tilesX * _tilesY), _sent(_tilesX * _tilesY, 0), _pendingSince(_tilesX * _tilesY, 0)
+        {
+        }
+
+        void setFrameBudget(size_t bytes)
+        {
+            _frameBudget = bytes;
+        }
+
+        // Forgets what the receiver has, the next messages resend every tile
+        void reset()
+        {
+            std::fill(_sent.begin(), _sent.end(), 0);
+        }
+
+        // Builds the update message for an RGBA8 frame, top row first
+        std::vector<uint8_t> encode(const uint8_t *rgba)
+        {
+            _frame++;
+            const int tileCount = _tilesX * _tilesY;
+
+            for (int t = 0; t < tileCount; t++)
+            {
+                const uint64_t hash = hashTile(rgba, t % _tilesX, t / _tilesX);
+                if (!_sent[t] || hash != _sentHashes[t])
+                {
+                    _sentHashes[t] = hash;
+                    _pendingSince[t] = _pendingSince[t] ? _pendingSince[t] : _frame;
+                    _sent[t] = 0;
+                }
+            }
+
+            // oldest pending tiles first, raster order within the same age
+            std::vector<int> dirty;
+            for (int t = 0; t < tileCount; t++)
+            {
+                if (_pendingSince[t])
+                {
+                    dirty.push_back(t);
+                }
+            }
+            std::stable_sort(dirty.begin(), dirty.end(), [this](int a, int b)
+                             { return _pendingSince[a] < _pendingSince[b]; });
+
+            std::vector<uint8_t> out = {'C', 'P', 'F', 'S'};
+            put32(out, _frame);
+            put16(out, _width);
+            put16(out, _height);
+            const size_t countOffset = out.size();
+            put16(out, 0);
+            put16(out, 0);
+
+            const size_t headerSize = out.size();
+            int rects = 0;
+            size_t next = 0;
+            while (next < dirty.size())
+            {
+                if (_frameBudget && rects > 0 && out.size() - headerSize >= _frameBudget)
+                {
+                    break;
+                }
+
+                // extend to the right over consecutive dirty tiles of the same row, short runs keep the
+                // overshoot past the budget to a few tiles
+                const int first = dirty[next];
+                size_t last = next;
+                while (last + 1 < dirty.size() && last - next + 1 < maxRunTiles && dirty[last + 1] == dirty[last] + 1 &&
+                       dirty[last + 1] / _tilesX == first / _tilesX)
+                {
+                    last++;
+                }
+
+                const int tx = first % _tilesX;
+                const int ty = first / _tilesX;
+                const int x = tx * _tileSize;
+                const int y = ty * _tileSize;
+                const int w = std::min(static_cast<int>(last - next + 1) * _tileSize, _width - x);
+                const int h = std::min(_tileSize, _height - y);
+                appendRect(out, rgba, x, y, w, h);
+                rects++;
+
+                for (size_t i = next; i <= last; i++)
+                {
+                    _pendingSince[dirty[i]] = 0;
+                    _sent[dirty[i]] = 1;
+                }
+                next = last + 1;
+            }
+
+            out[countOffset] = rects & 0xff;
+            out[countOffset + 1] = (rects >> 8) & 0xff;
+            const size_t pending = dirty.size() - next;
+            out[countOffset + 2] = pending & 0xff;
+            out[countOffset + 3] = (pending >> 8) & 0xff;
+            return out;
+        }
+    };
+
+    // Receiving side of FrameStreamer, keeps the reconstructed frame. Used by the loopback harness and
+    // as the reference for front-end decoders.
+    class FrameReceiver
+    {
+    private:
+        int _width = 0;
+        int _height = 0;
+        std::vector<uint8_t> _rgba;
+        std::vector<uint8_t> _rect;
+
+        static uint32_t get16(const uint8_t *p)
+        {
+            return p[0] | p[1] << 8;
+        }
+
+        static uint32_t get32(const uint8_t *p)
+        {
+            return get16(p) | get16(p + 2) << 16;
+        }
+
+    public:
+        bool apply(const uint8_t *data, size_t size)
+        {
+            if (size < 16 || std::memcmp(data, "CPFS", 4) != 0)
+            {
+                return false;
+            }
+            const int width = get16(data + 8);
+            const int height = get16(data + 10);
+            if (width != _width || height != _height)
+            {
+                _width = width;
+                _height = height;
+                _rgba.assign(static_cast<size_t>(width) * height * 4, 0);
+            }
+
+            const int rects = get16(data + 12);
+            size_t pos = 16;
+            for (int r = 0; r < rects; r++)
+            {
+                if (pos + 12 > size)
+                {
+                    return false;
+                }
+                const int x = get16(data + pos);
+                const int y = get16(data + pos + 2);
+                const uint32_t bytes = get32(data + pos + 8);
+                pos += 12;
+
+                int w = 0;
+                int h = 0;
+                if (pos + bytes > size || x >= _width || y >= _height ||
+                    !decodeQoi(data + pos, bytes, _rect, w, h, _width - x, _height - y))
+                {
+                    return false;
+                }
+                pos += bytes;
+
+                for (int row = 0; row < h; row++)
+                {
+                    std::memcpy(_rgba.data() + (static_cast<size_t>(y + row) * _width + x) * 4,
+                                _rect.data() + static_cast<size_t>(row) * w * 4, static_cast<size_t>(w) * 4);
+                }
+            }
+            return true;
+        }
+
+        [[nodiscard]] const std::vector<uint8_t> &pixels() const
+        {
+            return _rgba;
+        }
+    };
+
+    // Writes length-prefixed (u32 little endian) messages to a stream, e.g. the stdout pipe read by the
+    // notebook kernel which forwards them to the front-end over a comm channel
+    inline bool writeMessage(std::FILE *stream, const std::vector<uint8_t> &message)
+    {
+        const uint32_t size = static_cast<uint32_t>(message.size());
+        const uint8_t prefix[4] = {static_cast<uint8_t>(size), static_cast<uint8_t>(size >> 8),
+                                   static_cast<uint8_t>(size >> 16), static_cast<uint8_t>(size >> 24)};
+        return std::fwrite(prefix, 1, 4, stream) == 4 &&
+               std::fwrite(message.data(), 1, message.size(), stream) == message.size() && std::fflush(stream) == 0;
+    }
+}
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef CPPPLOT_GPU_TIMER_H
+#define CPPPLOT_GPU_TIMER_H
+
+#include "profiler.h"
+#include <GL/glew.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace cppplot
+{
+    // Measures GPU execution time of render passes with GL_TIMESTAMP query pairs. Queries are kept in a
+    // ring of `latency` frames and a frame is only read back when it comes round again, so fetching
+    // results never waits on the GPU. Results are recorded into profiler channels named "gpu <plot>/<pass>",
+    // next to the CPU stages, and lag the CPU timings of the same frame by latency frames (at least 2).
+    class GpuTimer
+    {
+    public:
+        class Scope
+        {
+        private:
+            GpuTimer &_timer;
+            size_t _pass;
+
+        public:
+            Scope(GpuTimer &timer, size_t pass) :
+                _timer(timer), _pass(pass)
+            {
+                _timer.begin(_pass);
+            }
+            Scope(const Scope &) = delete;
+            Scope &operator=(const Scope &) = delete;
+            ~Scope()
+            {
+                _timer.end(_pass);
+            }
+        };
+
+    private:
+        struct Interval
+        {
+            size_t pass;
+            size_t begin;
+            size_t end;
+        };
+
+        struct Frame
+        {
+            std::vector<GLuint> queries;
+            std::vector<Interval> intervals;
+            size_t used = 0;
+        };
+
+        FrameProfiler &_profiler;
+        std::vector<Frame> _frames;
+        std::vector<size_t> _channels;
+        std::vector<size_t> _open;
+        size_t _current = 0;
+        size_t _dropped = 0;
+
+        GLuint acquire()
+        {
+            Frame &frame = _frames[_current];
+            if (frame.used == frame.queries.size())
+            {
+                const size_t grow = std::max<size_t>(8, frame.queries.size());
+                frame.queries.resize(frame.queries.size() + grow);
+                glGenQueries(static_cast<GLsizei>(grow), frame.queries.data() + frame.used);
+            }
+            return frame.queries[frame.used++];
+        }
+
+        // Reads back the frame issued latency frames ago, dropping it if the GPU is still behind
+        void collect(Frame &frame)
+        {
+            if (frame.intervals.empty())
+            {
+                frame.used = 0;
+                return;
+            }
+
+            GLint available = 0;
+            glGetQueryObjectiv(frame.queries[frame.used - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available)
+            {
+                for (const auto &interval : frame.intervals)
+                {
+                    GLuint64 begin = 0;
+                    GLuint64 end = 0;
+                    glGetQueryObjectui64v(frame.queries[interval.begin], GL_QUERY_RESULT, &begin);
+                    glGetQueryObjectui64v(frame.queries[interval.end], GL_QUERY_RESULT, &end);
+                    _profiler.record(_channels[interval.pass], (end - begin) / 1e6);
+                }
+            }
+            else
+            {
+                _dropped++;
+            }
+
+            frame.intervals.clear();
+            frame.used = 0;
+        }
+
+    public:
+        explicit GpuTimer(FrameProfiler &profiler, size_t latency = 3) :
+            _profiler(profiler), _frames(std::max<size_t>(2, latency))
+        {
+        }
+
+        GpuTimer(const GpuTimer &) = delete;
+        GpuTimer &operator=(const GpuTimer &) = delete;
+
+        ~GpuTimer()
+        {
+            for (auto &frame : _frames)
+            {
+                if (!frame.queries.empty())
+                {
+                    glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+                }
+            }
+        }
+
+        // Registers a pass of a plot, returns the id to time it with
+        size_t addPass(const std::string &plot, const std::string &pass)
+        {
+            _channels.push_back(_profiler.addChannel("gpu " + plot + "/" + pass));
+            _open.push_back(0);
+            return _channels.size() - 1;
+        }
+
+        // Call after FrameProfiler::beginFrame(), records the oldest frame's results into the profiler
+        void beginFrame()
+        {
+            _current = (_current + 1) % _frames.size();
+            collect(_frames[_current]);
+        }
+
+        void begin(size_t pass)
+        {
+            _open[pass] = _frames[_current].used;
+            glQueryCounter(acquire(), GL_TIMESTAMP);
+        }
+
+        void end(size_t pass)
+        {
+            const size_t endQuery = _frames[_current].used;
+            glQueryCounter(acquire(), GL_TIMESTAMP);
+            _frames[_current].intervals.push_back({pass, _open[pass], endQuery});
+        }
+
+        [[nodiscard]] Scope scope(size_t pass)
+        {
+            return Scope(*this, pass);
+        }
+
+        // Frames whose results were not ready when their queries were recycled
+        [[nodiscard]] size_t droppedFrames() const
+        {
+            return _dropped;
+        }
+    };
+}
+
+#endif
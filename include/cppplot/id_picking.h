@@ -0,0 +1,336 @@
+#ifndef CPPPLOT_ID_PICKING_H
+#define CPPPLOT_ID_PICKING_H
+
+#include <GL/glew.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <glfwpp/glfwpp.h>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace cppplot
+{
+    // Picking by rendering vertex or instance IDs (shader variants with the PickId feature) into an R32UI
+    // framebuffer. Works under any transform the plot's shader applies, unlike a CPU index of data
+    // positions. A pick pass is drawn when the cursor has moved or the view changed (invalidate()), and
+    // for data changing under a still cursor (dataChanged()) at most once per refresh interval, so moving
+    // data does not add a pick pass to every frame. The pass is scissored to the small neighbourhood that
+    // is read back, and the readback goes asynchronously through a ring of pixel buffer objects and is
+    // collected by poll() once its fence has signalled, so picking never waits on the GPU. When every PBO
+    // is still in flight the request is skipped and retried on the next frame.
+    class IdPicker
+    {
+    public:
+        struct Hit
+        {
+            // vertex index (instance index for instanced shapes) of the nearest ID in the neighbourhood
+            uint32_t index;
+            // its pixel offset from the cursor, y down
+            int dx;
+            int dy;
+        };
+
+    private:
+        struct Slot
+        {
+            GLuint pbo = 0;
+            GLsync fence = nullptr;
+            uint64_t request = 0;
+            // read back region in GL pixels and the cursor within it
+            int x = 0;
+            int y = 0;
+            int width = 0;
+            int height = 0;
+            int cursorX = 0;
+            int cursorY = 0;
+        };
+
+        GLuint _fbo = 0;
+        GLuint _ids = 0;
+        int _width = 0;
+        int _height = 0;
+        int _radius;
+        std::vector<Slot> _slots;
+        size_t _next = 0;
+        uint64_t _requests = 0;
+        uint64_t _resultRequest = 0;
+        uint64_t _reportedRequest = 0;
+        std::optional<Hit> _result;
+        size_t _dropped = 0;
+        std::vector<uint32_t> _scratch;
+
+        int _lastX = -1;
+        int _lastY = -1;
+        bool _invalid = true;
+        bool _stale = false;
+        std::chrono::steady_clock::duration _refreshInterval;
+        std::chrono::steady_clock::time_point _lastPick;
+        Slot *_open = nullptr;
+
+        GLint _savedDraw = 0;
+        GLint _savedRead = 0;
+        GLint _savedViewport[4] = {};
+        GLint _savedScissorBox[4] = {};
+        GLboolean _savedScissor = GL_FALSE;
+
+        // Nearest non-zero ID to the cursor in a completed slot
+        void retire(Slot &slot)
+        {
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+
+            const size_t count = static_cast<size_t>(slot.width) * slot.height;
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+            const auto *ids = static_cast<const uint32_t *>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, count * sizeof(uint32_t), GL_MAP_READ_BIT));
+            if (ids)
+            {
+                _scratch.assign(ids, ids + count);
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+            // an older request completing late must not replace a newer result
+            if (!ids || slot.request < _resultRequest)
+            {
+                return;
+            }
+
+            std::optional<Hit> nearest;
+            int best = 0;
+            for (int y = 0; y < slot.height; y++)
+            {
+                for (int x = 0; x < slot.width; x++)
+                {
+                    const uint32_t id = _scratch[static_cast<size_t>(y) * slot.width + x];
+                    const int dx = x - slot.cursorX;
+                    const int dy = slot.cursorY - y;
+                    if (id != 0 && (!nearest || dx * dx + dy * dy < best))
+                    {
+                        nearest = Hit{id - 1, dx, dy};
+                        best = dx * dx + dy * dy;
+                    }
+                }
+            }
+            _result = nearest;
+            _resultRequest = slot.request;
+        }
+
+        void collect()
+        {
+            for (size_t i = 0; i < _slots.size(); i++)
+            {
+                Slot &slot = _slots[(_next + i) % _slots.size()];
+                if (slot.fence && glClientWaitSync(slot.fence, 0, 0) != GL_TIMEOUT_EXPIRED)
+                {
+                    retire(slot);
+                }
+            }
+        }
+
+    public:
+        // radius is the half-size in pixels of the square read back around the cursor; refreshInterval
+        // bounds how often changing data alone triggers a pick pass
+        IdPicker(int width, int height, int radius = 3, size_t ringSize = 3,
+                 std::chrono::milliseconds refreshInterval = std::chrono::milliseconds(100)) :
+            _radius(radius), _slots(ringSize < 2 ? 2 : ringSize), _refreshInterval(refreshInterval)
+        {
+            glGenFramebuffers(1, &_fbo);
+            glGenRenderbuffers(1, &_ids);
+
+            const auto bytes = static_cast<GLsizeiptr>((2 * radius + 1) * (2 * radius + 1) * sizeof(uint32_t));
+            for (auto &slot : _slots)
+            {
+                glGenBuffers(1, &slot.pbo);
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+                glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            resize(width, height);
+        }
+
+        IdPicker(const IdPicker &) = delete;
+        IdPicker &operator=(const IdPicker &) = delete;
+
+        // Needs the GL context to be current
+        ~IdPicker()
+        {
+            for (auto &slot : _slots)
+            {
+                if (slot.fence)
+                {
+                    glDeleteSync(slot.fence);
+                }
+                glDeleteBuffers(1, &slot.pbo);
+            }
+            glDeleteRenderbuffers(1, &_ids);
+            glDeleteFramebuffers(1, &_fbo);
+        }
+
+        // Match the size of the framebuffer the plot is drawn to
+        void resize(int width, int height)
+        {
+            if (width == _width && height == _height)
+            {
+                return;
+            }
+            _width = width;
+            _height = height;
+            _invalid = true;
+
+            GLint previous = 0;
+            glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous);
+            glBindRenderbuffer(GL_RENDERBUFFER, _ids);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_R32UI, width, height);
+            glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, _ids);
+            const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+            glBindFramebuffer(GL_FRAMEBUFFER, previous);
+            if (!complete)
+            {
+                throw std::runtime_error("ID picking framebuffer is incomplete");
+            }
+        }
+
+        // Forces the next begin() to pick even if the cursor has not moved, e.g. after the view changed
+        void invalidate()
+        {
+            _invalid = true;
+        }
+
+        // The plotted data changed, e.g. streamed samples: a still cursor is picked again once the refresh
+        // interval since the last pick has passed
+        void dataChanged()
+        {
+            _stale = true;
+        }
+
+        // Starts a pick pass at pixel (x, y) of the framebuffer, counted from the top-left like cursor
+        // positions. Returns false when there is nothing to do; otherwise binds the ID framebuffer, cleared
+        // within the scissored neighbourhood, and the caller draws the plot with its PickId shaders and
+        // calls end().
+        bool begin(int x, int y)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            const bool refresh = _stale && now - _lastPick >= _refreshInterval;
+            if (x == _lastX && y == _lastY && !_invalid && !refresh)
+            {
+                return false;
+            }
+            if (x < 0 || y < 0 || x >= _width || y >= _height)
+            {
+                _lastX = x;
+                _lastY = y;
+                _invalid = false;
+                _stale = false;
+                _result.reset();
+                _resultRequest = ++_requests;
+                return false;
+            }
+
+            collect();
+            Slot &slot = _slots[_next];
+            if (slot.fence)
+            {
+                _dropped++;
+                return false;
+            }
+            _lastX = x;
+            _lastY = y;
+            _invalid = false;
+            _stale = false;
+            _lastPick = now;
+
+            const int glY = _height - 1 - y;
+            slot.x = std::max(0, x - _radius);
+            slot.y = std::max(0, glY - _radius);
+            slot.width = std::min(_width, x + _radius + 1) - slot.x;
+            slot.height = std::min(_height, glY + _radius + 1) - slot.y;
+            slot.cursorX = x - slot.x;
+            slot.cursorY = glY - slot.y;
+            slot.request = ++_requests;
+            _open = &slot;
+
+            glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &_savedDraw);
+            glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &_savedRead);
+            glGetIntegerv(GL_VIEWPORT, _savedViewport);
+            glGetIntegerv(GL_SCISSOR_BOX, _savedScissorBox);
+            _savedScissor = glIsEnabled(GL_SCISSOR_TEST);
+
+            glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+            glViewport(0, 0, _width, _height);
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(slot.x, slot.y, slot.width, slot.height);
+            const GLuint background[4] = {0, 0, 0, 0};
+            glClearBufferuiv(GL_COLOR, 0, background);
+            return true;
+        }
+
+        // Queues the readback of the neighbourhood and restores the framebuffer, viewport and scissor state
+        void end()
+        {
+            if (!_open)
+            {
+                return;
+            }
+            Slot &slot = *_open;
+            _open = nullptr;
+
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, _fbo);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+            glPixelStorei(GL_PACK_ALIGNMENT, 4);
+            glReadPixels(slot.x, slot.y, slot.width, slot.height, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            glFlush();
+            _next = (_next + 1) % _slots.size();
+
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, _savedDraw);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, _savedRead);
+            glViewport(_savedViewport[0], _savedViewport[1], _savedViewport[2], _savedViewport[3]);
+            glScissor(_savedScissorBox[0], _savedScissorBox[1], _savedScissorBox[2], _savedScissorBox[3]);
+            if (!_savedScissor)
+            {
+                glDisable(GL_SCISSOR_TEST);
+            }
+        }
+
+        // begin() at the cursor of a window, resizing to its framebuffer first
+        bool begin(glfw::Window &window)
+        {
+            const auto [cursorX, cursorY] = window.getCursorPos();
+            const auto [width, height] = window.getSize();
+            const auto [fbWidth, fbHeight] = window.getFramebufferSize();
+            resize(fbWidth, fbHeight);
+            if (width <= 0 || height <= 0)
+            {
+                return false;
+            }
+            return begin(static_cast<int>(cursorX * fbWidth / width), static_cast<int>(cursorY * fbHeight / height));
+        }
+
+        // Collects finished readbacks without waiting; true when result() is newer than at the last poll()
+        bool poll()
+        {
+            collect();
+            const bool updated = _resultRequest != _reportedRequest;
+            _reportedRequest = _resultRequest;
+            return updated;
+        }
+
+        // What is under the cursor as of the latest completed pick, nothing over the background
+        [[nodiscard]] const std::optional<Hit> &result() const
+        {
+            return _result;
+        }
+
+        // Pick requests skipped because every PBO was still in flight
+        [[nodiscard]] size_t dropped() const
+        {
+            return _dropped;
+        }
+    };
+}
+
+#endif
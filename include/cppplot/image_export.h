@@ -0,0 +1,498 @@
+#ifndef CPPPLOT_IMAGE_EXPORT_H
+#define CPPPLOT_IMAGE_EXPORT_H
+
+#include "parallel.h"
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// PNG export is built with CPPPLOT_HAS_ZLIB, set by the build when zlib is linked
+#ifdef CPPPLOT_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace cppplot
+{
+    enum class ImageFormat
+    {
+        Png,
+        Qoi,
+        Raw
+    };
+
+    namespace detail
+    {
+        inline void putBigEndian(std::vector<uint8_t> &out, uint32_t value)
+        {
+            out.push_back(value >> 24);
+            out.push_back(value >> 16);
+            out.push_back(value >> 8);
+            out.push_back(value);
+        }
+    }
+
+    // QOI (https://qoiformat.org), lossless and several times faster to encode than PNG. rgba is RGBA8,
+    // top row first.
+    inline std::vector<uint8_t> encodeQoi(const uint8_t *rgba, int width, int height)
+    {
+        const size_t pixels = static_cast<size_t>(width) * height;
+        std::vector<uint8_t> out;
+        out.reserve(14 + pixels * 2 + 8);
+        out.insert(out.end(), {'q', 'o', 'i', 'f'});
+        detail::putBigEndian(out, width);
+        detail::putBigEndian(out, height);
+        out.push_back(4);
+        out.push_back(0);
+
+        uint32_t index[64] = {};
+        uint8_t prev[4] = {0, 0, 0, 255};
+        int run = 0;
+
+        for (size_t i = 0; i < pixels; i++)
+        {
+            const uint8_t *px = rgba + i * 4;
+            if (px[0] == prev[0] && px[1] == prev[1] && px[2] == prev[2] && px[3] == prev[3])
+            {
+                run++;
+                if (run == 62 || i == pixels - 1)
+                {
+                    out.push_back(0xc0 | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+
+            if (run > 0)
+            {
+                out.push_back(0xc0 | (run - 1));
+                run = 0;
+            }
+
+            const uint32_t packed = px[0] | px[1] << 8 | px[2] << 16 | static_cast<uint32_t>(px[3]) << 24;
+            const int hash = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+            if (index[hash] == packed)
+            {
+                out.push_back(hash);
+            }
+            else
+            {
+                index[hash] = packed;
+                if (px[3] == prev[3])
+                {
+                    const int8_t vr = static_cast<int8_t>(px[0] - prev[0]);
+                    const int8_t vg = static_cast<int8_t>(px[1] - prev[1]);
+                    const int8_t vb = static_cast<int8_t>(px[2] - prev[2]);
+                    const int vgr = vr - vg;
+                    const int vgb = vb - vg;
+
+                    if (vr >= -2 && vr <= 1 && vg >= -2 && vg <= 1 && vb >= -2 && vb <= 1)
+                    {
+                        out.push_back(0x40 | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2));
+                    }
+                    else if (vg >= -32 && vg <= 31 && vgr >= -8 && vgr <= 7 && vgb >= -8 && vgb <= 7)
+                    {
+                        out.push_back(0x80 | (vg + 32));
+                        out.push_back((vgr + 8) << 4 | (vgb + 8));
+                    }
+                    else
+                    {
+                        out.insert(out.end(), {0xfe, px[0], px[1], px[2]});
+                    }
+                }
+                else
+                {
+                    out.insert(out.end(), {0xff, px[0], px[1], px[2], px[3]});
+                }
+            }
+            prev[0] = px[0];
+            prev[1] = px[1];
+            prev[2] = px[2];
+            prev[3] = px[3];
+        }
+
+        out.insert(out.end(), {0, 0, 0, 0, 0, 0, 0, 1});
+        return out;
+    }
+
+    // Decodes a 4-channel QOI image into RGBA8, returns false on malformed input and on images empty or
+    // larger than maxWidth x maxHeight, before anything is allocated
+    inline bool decodeQoi(const uint8_t *data, size_t size, std::vector<uint8_t> &rgba, int &width, int &height,
+                          int maxWidth = 16384, int maxHeight = 16384)
+    {
+        if (size < 22 || data[0] != 'q' || data[1] != 'o' || data[2] != 'i' || data[3] != 'f')
+        {
+            return false;
+        }
+        const uint32_t w = uint32_t(data[4]) << 24 | uint32_t(data[5]) << 16 | uint32_t(data[6]) << 8 | data[7];
+        const uint32_t h = uint32_t(data[8]) << 24 | uint32_t(data[9]) << 16 | uint32_t(data[10]) << 8 | data[11];
+        // a run byte covers at most 62 pixels
+        if (w == 0 || h == 0 || maxWidth <= 0 || maxHeight <= 0 || w > uint32_t(maxWidth) || h > uint32_t(maxHeight) ||
+            static_cast<uint64_t>(w) * h > static_cast<uint64_t>(size - 22) * 62)
+        {
+            return false;
+        }
+        width = static_cast<int>(w);
+        height = static_cast<int>(h);
+        const size_t pixels = static_cast<size_t>(width) * height;
+        rgba.resize(pixels * 4);
+
+        uint8_t index[64][4] = {};
+        uint8_t px[4] = {0, 0, 0, 255};
+        size_t pos = 14;
+        const size_t end = size - 8;
+        int run = 0;
+
+        for (size_t i = 0; i < pixels; i++)
+        {
+            if (run > 0)
+            {
+                run--;
+            }
+            else if (pos < end)
+            {
+                const uint8_t b = data[pos++];
+                if (b == 0xfe && pos + 3 <= end)
+                {
+                    px[0] = data[pos];
+                    px[1] = data[pos + 1];
+                    px[2] = data[pos + 2];
+                    pos += 3;
+                }
+                else if (b == 0xff && pos + 4 <= end)
+                {
+                    px[0] = data[pos];
+                    px[1] = data[pos + 1];
+                    px[2] = data[pos + 2];
+                    px[3] = data[pos + 3];
+                    pos += 4;
+                }
+                else if ((b & 0xc0) == 0x00)
+                {
+                    std::copy(index[b], index[b] + 4, px);
+                }
+                else if ((b & 0xc0) == 0x40)
+                {
+                    px[0] += ((b >> 4) & 3) - 2;
+                    px[1] += ((b >> 2) & 3) - 2;
+                    px[2] += (b & 3) - 2;
+                }
+                else if ((b & 0xc0) == 0x80 && pos < end)
+                {
+                    const int vg = (b & 0x3f) - 32;
+                    const uint8_t b2 = data[pos++];
+                    px[0] += vg - 8 + (b2 >> 4);
+                    px[1] += vg;
+                    px[2] += vg - 8 + (b2 & 0x0f);
+                }
+                else if ((b & 0xc0) == 0xc0)
+                {
+                    run = b & 0x3f;
+                }
+                std::copy(px, px + 4, index[(px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64]);
+            }
+            else
+            {
+                return false;
+            }
+            std::copy(px, px + 4, rgba.data() + i * 4);
+        }
+        return true;
+    }
+
+#ifdef CPPPLOT_HAS_ZLIB
+    namespace detail
+    {
+        // Writes the filter byte and filtered row, choosing the filter with the smallest sum of absolute
+        // residuals as libpng does
+        inline void filterPngRow(const uint8_t *row, const uint8_t *above, size_t stride, uint8_t *out,
+                                 std::vector<uint8_t> &scratch)
+        {
+            scratch.resize(stride * 5);
+            uint8_t *candidates[5];
+            long costs[5] = {};
+            for (int f = 0; f < 5; f++)
+            {
+                candidates[f] = scratch.data() + f * stride;
+            }
+
+            for (size_t i = 0; i < stride; i++)
+            {
+                const int a = i >= 4 ? row[i - 4] : 0;
+                const int b = above ? above[i] : 0;
+                const int c = above && i >= 4 ? above[i - 4] : 0;
+
+                const int p = a + b - c;
+                const int pa = std::abs(p - a);
+                const int pb = std::abs(p - b);
+                const int pc = std::abs(p - c);
+                const int paeth = pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+
+                const uint8_t values[5] = {row[i], static_cast<uint8_t>(row[i] - a), static_cast<uint8_t>(row[i] - b),
+                                           static_cast<uint8_t>(row[i] - (a + b) / 2),
+                                           static_cast<uint8_t>(row[i] - paeth)};
+                for (int f = 0; f < 5; f++)
+                {
+                    candidates[f][i] = values[f];
+                    costs[f] += std::abs(static_cast<int8_t>(values[f]));
+                }
+            }
+
+            int best = 0;
+            for (int f = 1; f < 5; f++)
+            {
+                if (costs[f] < costs[best])
+                {
+                    best = f;
+                }
+            }
+            out[0] = static_cast<uint8_t>(best);
+            std::copy(candidates[best], candidates[best] + stride, out + 1);
+        }
+
+        inline void putPngChunk(std::vector<uint8_t> &out, const char *type, const uint8_t *data, size_t size)
+        {
+            putBigEndian(out, static_cast<uint32_t>(size));
+            const size_t start = out.size();
+            out.insert(out.end(), type, type + 4);
+            out.insert(out.end(), data, data + size);
+            putBigEndian(out, crc32(0, out.data() + start, static_cast<uInt>(size + 4)));
+        }
+    }
+
+    // PNG (RGBA8) encoder. The rows are split into one band per thread; each band is filtered and deflated
+    // independently, non-final bands ending on a sync flush so the raw deflate streams concatenate into a
+    // single valid zlib stream whose Adler-32 is combined from the bands. threads == 0 uses every core.
+    inline std::vector<uint8_t> encodePng(const uint8_t *rgba, int width, int height, size_t threads = 1, int level = 6)
+    {
+        const size_t stride = static_cast<size_t>(width) * 4;
+        const size_t bandCount = std::max<size_t>(1, std::min<size_t>(threads ? threads : hardwareThreads(), height));
+        std::vector<std::vector<uint8_t>> bands(bandCount);
+        std::vector<uLong> checksums(bandCount);
+        std::vector<size_t> lengths(bandCount);
+
+        parallelFor(height, bandCount, [&](size_t band, size_t begin, size_t end)
+                    {
+                        std::vector<uint8_t> filtered((end - begin) * (stride + 1));
+                        std::vector<uint8_t> scratch;
+                        for (size_t y = begin; y < end; y++)
+                        {
+                            detail::filterPngRow(rgba + y * stride, y > 0 ? rgba + (y - 1) * stride : nullptr, stride,
+                                                 filtered.data() + (y - begin) * (stride + 1), scratch);
+                        }
+                        checksums[band] = adler32(adler32(0, nullptr, 0), filtered.data(), static_cast<uInt>(filtered.size()));
+                        lengths[band] = filtered.size();
+
+                        z_stream stream = {};
+                        deflateInit2(&stream, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+                        auto &out = bands[band];
+                        out.resize(deflateBound(&stream, static_cast<uLong>(filtered.size())) + 16);
+                        stream.next_in = filtered.data();
+                        stream.avail_in = static_cast<uInt>(filtered.size());
+                        stream.next_out = out.data();
+                        stream.avail_out = static_cast<uInt>(out.size());
+                        deflate(&stream, end == static_cast<size_t>(height) ? Z_FINISH : Z_SYNC_FLUSH);
+                        out.resize(stream.total_out);
+                        deflateEnd(&stream);
+                    });
+
+        std::vector<uint8_t> zlibStream = {0x78, 0x9c};
+        uLong checksum = checksums[0];
+        for (size_t i = 0; i < bandCount; i++)
+        {
+            zlibStream.insert(zlibStream.end(), bands[i].begin(), bands[i].end());
+            if (i > 0)
+            {
+                checksum = adler32_combine(checksum, checksums[i], static_cast<z_off_t>(lengths[i]));
+            }
+        }
+        detail::putBigEndian(zlibStream, static_cast<uint32_t>(checksum));
+
+        std::vector<uint8_t> header;
+        detail::putBigEndian(header, width);
+        detail::putBigEndian(header, height);
+        header.insert(header.end(), {8, 6, 0, 0, 0});
+
+        std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+        png.reserve(png.size() + zlibStream.size() + 64);
+        detail::putPngChunk(png, "IHDR", header.data(), header.size());
+        detail::putPngChunk(png, "IDAT", zlibStream.data(), zlibStream.size());
+        detail::putPngChunk(png, "IEND", nullptr, 0);
+        return png;
+    }
+#endif
+
+    inline ImageFormat formatFromPath(const std::string &path)
+    {
+        const auto dot = path.rfind('.');
+        const std::string extension = dot == std::string::npos ? "" : path.substr(dot + 1);
+        if (extension == "qoi")
+        {
+            return ImageFormat::Qoi;
+        }
+        if (extension == "rgba" || extension == "raw")
+        {
+            return ImageFormat::Raw;
+        }
+        return ImageFormat::Png;
+    }
+
+    // Encodes and writes images on a pool of worker threads, one image per worker at a time, so batch
+    // export scales with the number of cores. submit() blocks while maxQueued images are waiting, bounding
+    // the memory held by the pipeline.
+    class ImageExporter
+    {
+    private:
+        struct Job
+        {
+            std::vector<uint8_t> rgba;
+            int width;
+            int height;
+            std::string path;
+            ImageFormat format;
+        };
+
+        size_t _maxQueued;
+        int _pngLevel;
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        std::condition_variable _space;
+        std::condition_variable _idle;
+        std::deque<Job> _queue;
+        size_t _active = 0;
+        size_t _written = 0;
+        size_t _failed = 0;
+        bool _stopping = false;
+        std::vector<std::thread> _workers;
+
+        bool write(const Job &job) const
+        {
+            std::vector<uint8_t> encoded;
+            const uint8_t *data = job.rgba.data();
+            size_t size = job.rgba.size();
+
+            if (job.format == ImageFormat::Qoi)
+            {
+                encoded = encodeQoi(job.rgba.data(), job.width, job.height);
+            }
+            else if (job.format == ImageFormat::Png)
+            {
+#ifdef CPPPLOT_HAS_ZLIB
+                encoded = encodePng(job.rgba.data(), job.width, job.height, 1, _pngLevel);
+#else
+                return false;
+#endif
+            }
+            if (!encoded.empty())
+            {
+                data = encoded.data();
+                size = encoded.size();
+            }
+
+            std::FILE *file = std::fopen(job.path.c_str(), "wb");
+            if (!file)
+            {
+                return false;
+            }
+            const bool ok = std::fwrite(data, 1, size, file) == size;
+            return std::fclose(file) == 0 && ok;
+        }
+
+        void workerLoop()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (true)
+            {
+                _wake.wait(lock, [this]
+                           { return !_queue.empty() || _stopping; });
+                if (_queue.empty())
+                {
+                    return;
+                }
+
+                Job job = std::move(_queue.front());
+                _queue.pop_front();
+                _active++;
+                _space.notify_one();
+                lock.unlock();
+
+                const bool ok = write(job);
+
+                lock.lock();
+                _active--;
+                ok ? _written++ : _failed++;
+                _idle.notify_all();
+            }
+        }
+
+    public:
+        explicit ImageExporter(size_t threads = 0, size_t maxQueued = 16, int pngLevel = 6) :
+            _maxQueued(maxQueued), _pngLevel(pngLevel)
+        {
+            const size_t count = threads ? threads : hardwareThreads();
+            for (size_t i = 0; i < count; i++)
+            {
+                _workers.emplace_back(&ImageExporter::workerLoop, this);
+            }
+        }
+
+        ImageExporter(const ImageExporter &) = delete;
+        ImageExporter &operator=(const ImageExporter &) = delete;
+
+        ~ImageExporter()
+        {
+            finish();
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stopping = true;
+                _wake.notify_all();
+            }
+            for (auto &worker : _workers)
+            {
+                worker.join();
+            }
+        }
+
+        // Queues RGBA8 pixels (top row first) to be written to path, the format following its extension
+        void submit(std::vector<uint8_t> rgba, int width, int height, const std::string &path)
+        {
+            submit(std::move(rgba), width, height, path, formatFromPath(path));
+        }
+
+        void submit(std::vector<uint8_t> rgba, int width, int height, const std::string &path, ImageFormat format)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _space.wait(lock, [this]
+                        { return _queue.size() < _maxQueued; });
+            _queue.push_back({std::move(rgba), width, height, path, format});
+            _wake.notify_one();
+        }
+
+        // Blocks until every submitted image has been written
+        void finish()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _idle.wait(lock, [this]
+                       { return _queue.empty() && _active == 0; });
+        }
+
+        [[nodiscard]] size_t written()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _written;
+        }
+
+        [[nodiscard]] size_t failed()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _failed;
+        }
+    };
+}
+
+#endif
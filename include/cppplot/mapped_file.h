@@ -0,0 +1,352 @@
+#ifndef CPPPLOT_MAPPED_FILE_H
+#define CPPPLOT_MAPPED_FILE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cppplot
+{
+    // Page cache hints for a range of a mapped file
+    enum class Access
+    {
+        Normal,
+        // read in order, e.g. a roll plot replaying a recording: larger read-ahead, pages dropped sooner
+        Sequential,
+        // jumping around, e.g. zooming: no read-around beyond the pages touched
+        Random,
+        // about to be read, e.g. the visible range: paged in asynchronously now
+        WillNeed,
+        // not needed any more: the pages may be dropped from memory
+        DontNeed
+    };
+
+    // Read-only memory mapping of a whole file. Opening only sets up the mapping, pages are read from disk
+    // when first touched, so files larger than memory open instantly and cost only the ranges read.
+    class MappedFile
+    {
+    private:
+        const uint8_t *_data = nullptr;
+        size_t _size = 0;
+#if defined(_WIN32)
+        HANDLE _file = INVALID_HANDLE_VALUE;
+        HANDLE _mapping = nullptr;
+#endif
+
+        void close()
+        {
+#if defined(_WIN32)
+            if (_data)
+            {
+                UnmapViewOfFile(_data);
+            }
+            if (_mapping)
+            {
+                CloseHandle(_mapping);
+            }
+            if (_file != INVALID_HANDLE_VALUE)
+            {
+                CloseHandle(_file);
+            }
+            _file = INVALID_HANDLE_VALUE;
+            _mapping = nullptr;
+#else
+            if (_data)
+            {
+                munmap(const_cast<uint8_t *>(_data), _size);
+            }
+#endif
+            _data = nullptr;
+            _size = 0;
+        }
+
+    public:
+        // Throws std::runtime_error when the file cannot be opened or mapped
+        explicit MappedFile(const std::string &path)
+        {
+#if defined(_WIN32)
+            _file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            LARGE_INTEGER size;
+            if (_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(_file, &size))
+            {
+                close();
+                throw std::runtime_error("Could not open " + path);
+            }
+            _size = static_cast<size_t>(size.QuadPart);
+            if (_size == 0)
+            {
+                return;
+            }
+            _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            _data = _mapping ? static_cast<const uint8_t *>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+            if (!_data)
+            {
+                close();
+                throw std::runtime_error("Could not map " + path);
+            }
+#else
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            struct stat info;
+            if (fd < 0 || fstat(fd, &info) != 0)
+            {
+                if (fd >= 0)
+                {
+                    ::close(fd);
+                }
+                throw std::runtime_error("Could not open " + path);
+            }
+            _size = static_cast<size_t>(info.st_size);
+            void *data = _size ? mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0) : nullptr;
+            // the mapping keeps the file referenced
+            ::close(fd);
+            if (data == MAP_FAILED)
+            {
+                _size = 0;
+                throw std::runtime_error("Could not map " + path);
+            }
+            _data = static_cast<const uint8_t *>(data);
+#endif
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        ~MappedFile()
+        {
+            close();
+        }
+
+        [[nodiscard]] const uint8_t *data() const
+        {
+            return _data;
+        }
+
+        [[nodiscard]] size_t size() const
+        {
+            return _size;
+        }
+
+        // Hints the page cache about bytes [offset, offset + bytes), widened to whole pages. A hint only,
+        // failures are ignored; without madvise (Windows) it does nothing.
+        void advise(size_t offset, size_t bytes, Access access) const
+        {
+#if defined(_WIN32)
+            (void)offset;
+            (void)bytes;
+            (void)access;
+#else
+            if (!_data || offset >= _size)
+            {
+                return;
+            }
+            static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            const size_t begin = offset / page * page;
+            const size_t end = std::min(_size, offset + bytes);
+            int advice = MADV_NORMAL;
+            switch (access)
+            {
+            case Access::Sequential:
+                advice = MADV_SEQUENTIAL;
+                break;
+            case Access::Random:
+                advice = MADV_RANDOM;
+                break;
+            case Access::WillNeed:
+                advice = MADV_WILLNEED;
+                break;
+            case Access::DontNeed:
+                advice = MADV_DONTNEED;
+                break;
+            default:
+                break;
+            }
+            madvise(const_cast<uint8_t *>(_data) + begin, end - begin, advice);
+#endif
+        }
+    };
+
+    // One channel of interleaved samples: count values of T, stride values apart. Views point into the
+    // mapping and stay valid while the SampleFile lives; nothing is read until a value is.
+    template <typename T>
+    class ChannelView
+    {
+    private:
+        const T *_first = nullptr;
+        size_t _count = 0;
+        size_t _stride = 1;
+
+    public:
+        ChannelView() = default;
+
+        ChannelView(const T *first, size_t count, size_t stride) :
+            _first(first), _count(count), _stride(stride)
+        {
+        }
+
+        [[nodiscard]] size_t size() const
+        {
+            return _count;
+        }
+
+        [[nodiscard]] T operator[](size_t i) const
+        {
+            return _first[i * _stride];
+        }
+
+        // First value and the distance between values in bytes, e.g. for glVertexAttribPointer on a
+        // buffer holding the same interleaved bytes
+        [[nodiscard]] const T *data() const
+        {
+            return _first;
+        }
+
+        [[nodiscard]] size_t strideBytes() const
+        {
+            return _stride * sizeof(T);
+        }
+
+        // Values [first, first + count), clamped to the view
+        [[nodiscard]] ChannelView range(size_t first, size_t count) const
+        {
+            first = std::min(first, _count);
+            return ChannelView(_first + first * _stride, std::min(count, _count - first), _stride);
+        }
+
+        // Interleaved x, y floats as the line and roll vertex buffers hold them: x is the sample index
+        // (x0 for the first value of the view) and y the value * scale + offset. Writes size() vertices.
+        void copyXy(float *xy, double x0 = 0, float scale = 1.0f, float offset = 0.0f) const
+        {
+            for (size_t i = 0; i < _count; i++)
+            {
+                xy[i * 2] = static_cast<float>(x0 + static_cast<double>(i));
+                xy[i * 2 + 1] = static_cast<float>(_first[i * _stride]) * scale + offset;
+            }
+        }
+
+        // decimateMinMax read straight from the mapping: the min and max of each of columns buckets in
+        // their original order, as xy like copyXy, without converting the samples in between. Writes up to
+        // 2 * columns vertices and returns their number; short views are copied unchanged.
+        size_t decimate(size_t columns, float *xy, double x0 = 0, float scale = 1.0f, float offset = 0.0f) const
+        {
+            if (_count <= 2 * columns)
+            {
+                copyXy(xy, x0, scale, offset);
+                return _count;
+            }
+
+            size_t written = 0;
+            for (size_t c = 0; c < columns; c++)
+            {
+                const size_t begin = c * _count / columns;
+                const size_t end = (c + 1) * _count / columns;
+                size_t low = begin;
+                size_t high = begin;
+                T lowValue = _first[begin * _stride];
+                T highValue = lowValue;
+                for (size_t i = begin + 1; i < end; i++)
+                {
+                    const T value = _first[i * _stride];
+                    if (value < lowValue)
+                    {
+                        lowValue = value;
+                        low = i;
+                    }
+                    if (value > highValue)
+                    {
+                        highValue = value;
+                        high = i;
+                    }
+                }
+                for (const size_t i : {std::min(low, high), std::max(low, high)})
+                {
+                    xy[written * 2] = static_cast<float>(x0 + static_cast<double>(i));
+                    xy[written * 2 + 1] = static_cast<float>(_first[i * _stride]) * scale + offset;
+                    written++;
+                }
+            }
+            return written;
+        }
+    };
+
+    // A recording of raw interleaved samples, frames of channels values of T (int16_t or float), after
+    // headerBytes of anything else. A trailing partial frame is ignored.
+    template <typename T>
+    class SampleFile
+    {
+        static_assert(std::is_same_v<T, int16_t> || std::is_same_v<T, float>, "samples are int16_t or float");
+
+    private:
+        MappedFile _file;
+        size_t _channels;
+        size_t _headerBytes;
+        size_t _frames;
+
+    public:
+        SampleFile(const std::string &path, size_t channels, size_t headerBytes = 0) :
+            _file(path), _channels(std::max<size_t>(channels, 1)), _headerBytes(headerBytes),
+            _frames(_file.size() > headerBytes ? (_file.size() - headerBytes) / (_channels * sizeof(T)) : 0)
+        {
+            if (headerBytes % alignof(T) != 0)
+            {
+                throw std::runtime_error("Sample data must start at a multiple of the sample size");
+            }
+        }
+
+        [[nodiscard]] size_t frames() const
+        {
+            return _frames;
+        }
+
+        [[nodiscard]] size_t channels() const
+        {
+            return _channels;
+        }
+
+        [[nodiscard]] const MappedFile &file() const
+        {
+            return _file;
+        }
+
+        [[nodiscard]] ChannelView<T> channel(size_t index) const
+        {
+            if (index >= _channels)
+            {
+                throw std::runtime_error("Channel " + std::to_string(index) + " out of range");
+            }
+            // an empty file has no mapping to point into
+            if (_frames == 0)
+            {
+                return ChannelView<T>();
+            }
+            const auto *samples = reinterpret_cast<const T *>(_file.data() + _headerBytes);
+            return ChannelView<T>(samples + index, _frames, _channels);
+        }
+
+        // Page cache hint for frames [first, first + count) of every channel, e.g. WillNeed for the range
+        // about to become visible and DontNeed for the one scrolled away from
+        void advise(size_t first, size_t count, Access access) const
+        {
+            const size_t frameBytes = _channels * sizeof(T);
+            first = std::min(first, _frames);
+            count = std::min(count, _frames - first);
+            _file.advise(_headerBytes + first * frameBytes, count * frameBytes, access);
+        }
+    };
+}
+
+#endif
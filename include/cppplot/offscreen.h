@@ -0,0 +1,308 @@
+#ifndef CPPPLOT_OFFSCREEN_H
+#define CPPPLOT_OFFSCREEN_H
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// OffscreenContext is built with CPPPLOT_HAS_EGL, set by the build when libEGL is linked
+#ifdef CPPPLOT_HAS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+namespace cppplot
+{
+    // Reverses the rows of an RGBA8 image, GL rows start at the bottom
+    inline void flipRows(std::vector<uint8_t> &pixels, int width, int height)
+    {
+        const size_t rowBytes = static_cast<size_t>(width) * 4;
+        std::vector<uint8_t> row(rowBytes);
+        for (int y = 0; y < height / 2; y++)
+        {
+            uint8_t *top = pixels.data() + y * rowBytes;
+            uint8_t *bottom = pixels.data() + (height - 1 - y) * rowBytes;
+            std::memcpy(row.data(), top, rowBytes);
+            std::memcpy(top, bottom, rowBytes);
+            std::memcpy(bottom, row.data(), rowBytes);
+        }
+    }
+
+    // Colour render target for offscreen rendering, an RGBA8 renderbuffer attached to a framebuffer object
+    class Framebuffer
+    {
+    private:
+        GLuint _fbo = 0;
+        GLuint _color = 0;
+        int _width = 0;
+        int _height = 0;
+
+    public:
+        Framebuffer(int width, int height)
+        {
+            glGenFramebuffers(1, &_fbo);
+            glGenRenderbuffers(1, &_color);
+            resize(width, height);
+        }
+
+        Framebuffer(const Framebuffer &) = delete;
+        Framebuffer &operator=(const Framebuffer &) = delete;
+
+        ~Framebuffer()
+        {
+            glDeleteRenderbuffers(1, &_color);
+            glDeleteFramebuffers(1, &_fbo);
+        }
+
+        void resize(int width, int height)
+        {
+            _width = width;
+            _height = height;
+
+            glBindRenderbuffer(GL_RENDERBUFFER, _color);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+            glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, _color);
+
+            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            {
+                throw std::runtime_error("Offscreen framebuffer is incomplete");
+            }
+            glViewport(0, 0, width, height);
+        }
+
+        void bind() const
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+            glViewport(0, 0, _width, _height);
+        }
+
+        [[nodiscard]] GLuint id() const
+        {
+            return _fbo;
+        }
+
+        [[nodiscard]] int width() const
+        {
+            return _width;
+        }
+
+        [[nodiscard]] int height() const
+        {
+            return _height;
+        }
+
+        // Blocking read of the whole target as RGBA8, top row first
+        [[nodiscard]] std::vector<uint8_t> readPixels() const
+        {
+            const size_t rowBytes = static_cast<size_t>(_width) * 4;
+            std::vector<uint8_t> pixels(rowBytes * _height);
+
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, _fbo);
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            glReadPixels(0, 0, _width, _height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+            flipRows(pixels, _width, _height);
+            return pixels;
+        }
+    };
+
+#ifdef CPPPLOT_HAS_EGL
+    // Desktop GL context without any window or display server. Uses the Mesa surfaceless platform when
+    // available (llvmpipe in containers) and the default EGL display otherwise; the context is made
+    // current without a surface, or with a 1x1 pbuffer if surfaceless contexts are not supported.
+    // Rendering is meant to go to a Framebuffer. A context created with a share context uses the same
+    // display and shares its programs, buffers and textures; the share context must outlive it.
+    class OffscreenContext
+    {
+    private:
+        EGLDisplay _display = EGL_NO_DISPLAY;
+        EGLConfig _config = nullptr;
+        EGLContext _context = EGL_NO_CONTEXT;
+        EGLSurface _surface = EGL_NO_SURFACE;
+
+        // EGL hands out one display per platform, so it is terminated with the last context using it
+        static std::map<EGLDisplay, int> &displayUsers()
+        {
+            static std::map<EGLDisplay, int> users;
+            return users;
+        }
+
+        static bool hasExtension(const char *extensions, const char *name)
+        {
+            return extensions && std::strstr(extensions, name);
+        }
+
+        void createContext(int major, int minor, EGLContext share)
+        {
+            // software drivers may lag behind the requested version, fall back to what the demos need
+            const EGLint versions[][2] = {{major, minor}, {4, 5}, {3, 3}};
+            for (const auto &version : versions)
+            {
+                const EGLint contextAttributes[] = {EGL_CONTEXT_MAJOR_VERSION, version[0],
+                                                    EGL_CONTEXT_MINOR_VERSION, version[1],
+                                                    EGL_CONTEXT_OPENGL_PROFILE_MASK,
+                                                    EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE};
+                _context = eglCreateContext(_display, _config, share, contextAttributes);
+                if (_context != EGL_NO_CONTEXT)
+                {
+                    break;
+                }
+            }
+            if (_context == EGL_NO_CONTEXT)
+            {
+                throw std::runtime_error("Could not create an OpenGL context with EGL");
+            }
+
+            if (!hasExtension(eglQueryString(_display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context"))
+            {
+                const EGLint pbufferAttributes[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+                _surface = eglCreatePbufferSurface(_display, _config, pbufferAttributes);
+            }
+            makeCurrent();
+        }
+
+        // Everything created so far, also after a failed construction
+        void release()
+        {
+            if (_display == EGL_NO_DISPLAY)
+            {
+                return;
+            }
+            if (_context != EGL_NO_CONTEXT && eglGetCurrentContext() == _context)
+            {
+                eglMakeCurrent(_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            }
+            if (_surface != EGL_NO_SURFACE)
+            {
+                eglDestroySurface(_display, _surface);
+            }
+            if (_context != EGL_NO_CONTEXT)
+            {
+                eglDestroyContext(_display, _context);
+            }
+            if (--displayUsers()[_display] == 0)
+            {
+                displayUsers().erase(_display);
+                eglTerminate(_display);
+            }
+            _display = EGL_NO_DISPLAY;
+            _context = EGL_NO_CONTEXT;
+            _surface = EGL_NO_SURFACE;
+        }
+
+        void open(int major, int minor, const OffscreenContext *share)
+        {
+            if (share)
+            {
+                _display = share->_display;
+                _config = share->_config;
+                displayUsers()[_display]++;
+                createContext(major, minor, share->_context);
+                return;
+            }
+
+            const char *clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+            const auto getPlatformDisplay =
+                reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+            EGLDisplay display = EGL_NO_DISPLAY;
+            if (getPlatformDisplay && hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless"))
+            {
+                display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            }
+            if (display == EGL_NO_DISPLAY)
+            {
+                display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+            }
+            if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+            {
+                throw std::runtime_error("Could not initialize EGL");
+            }
+            // from here on release() owns a reference to the display
+            _display = display;
+            displayUsers()[_display]++;
+            if (!eglBindAPI(EGL_OPENGL_API))
+            {
+                throw std::runtime_error("EGL does not support desktop OpenGL");
+            }
+
+            const EGLint pbufferConfig[] = {EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                                            EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_NONE};
+            const EGLint anyConfig[] = {EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+            EGLint count = 0;
+            eglChooseConfig(_display, pbufferConfig, &_config, 1, &count);
+            if (count == 0)
+            {
+                eglChooseConfig(_display, anyConfig, &_config, 1, &count);
+            }
+            if (count == 0)
+            {
+                throw std::runtime_error("No EGL config for desktop OpenGL");
+            }
+            createContext(major, minor, EGL_NO_CONTEXT);
+        }
+
+    public:
+        // Throws std::runtime_error when no context can be created; whatever was created is released again
+        OffscreenContext(int major = 4, int minor = 6, const OffscreenContext *share = nullptr)
+        {
+            try
+            {
+                open(major, minor, share);
+            }
+            catch (...)
+            {
+                release();
+                throw;
+            }
+        }
+
+        OffscreenContext(const OffscreenContext &) = delete;
+        OffscreenContext &operator=(const OffscreenContext &) = delete;
+
+        ~OffscreenContext()
+        {
+            release();
+        }
+
+        void makeCurrent() const
+        {
+            if (!eglMakeCurrent(_display, _surface, _surface, _context))
+            {
+                throw std::runtime_error("Could not make the EGL context current");
+            }
+        }
+    };
+#endif
+
+    // Writes RGBA8 pixels (top row first) as a binary PPM, dropping alpha
+    inline bool writePpm(const std::string &path, int width, int height, const std::vector<uint8_t> &rgba)
+    {
+        std::FILE *file = std::fopen(path.c_str(), "wb");
+        if (!file)
+        {
+            return false;
+        }
+        std::fprintf(file, "P6\n%d %d\n255\n", width, height);
+        std::vector<uint8_t> rgb(static_cast<size_t>(width) * 3);
+        for (int y = 0; y < height; y++)
+        {
+            const uint8_t *src = rgba.data() + static_cast<size_t>(y) * width * 4;
+            for (int x = 0; x < width; x++)
+            {
+                rgb[x * 3] = src[x * 4];
+                rgb[x * 3 + 1] = src[x * 4 + 1];
+                rgb[x * 3 + 2] = src[x * 4 + 2];
+            }
+            std::fwrite(rgb.data(), 1, rgb.size(), file);
+        }
+        return std::fclose(file) == 0;
+    }
+}
+
+#endif
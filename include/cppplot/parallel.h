@@ -0,0 +1,50 @@
+#ifndef CPPPLOT_PARALLEL_H
+#define CPPPLOT_PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace cppplot
+{
+    inline size_t hardwareThreads()
+    {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Splits [0, count) into one contiguous chunk per thread and calls fn(chunk, begin, end) for each,
+    // the calling thread taking the first chunk. threads == 0 uses every hardware thread.
+    template <typename Fn>
+    void parallelFor(size_t count, size_t threads, Fn fn)
+    {
+        if (threads == 0)
+        {
+            threads = hardwareThreads();
+        }
+        threads = std::max<size_t>(1, std::min(threads, count));
+        if (threads == 1)
+        {
+            if (count > 0)
+            {
+                fn(size_t(0), size_t(0), count);
+            }
+            return;
+        }
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (size_t t = 1; t < threads; t++)
+        {
+            workers.emplace_back([&fn, t, count, threads]
+                                 { fn(t, count * t / threads, count * (t + 1) / threads); });
+        }
+        fn(size_t(0), size_t(0), count / threads);
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,360 @@
+#ifndef CPPPLOT_PROFILER_H
+#define CPPPLOT_PROFILER_H
+
+#include "trace.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace cppplot
+{
+    // Built-in per-frame stages, each one is a profiler channel
+    enum class Stage
+    {
+        Frame,
+        DataUpdate,
+        Upload,
+        Draw,
+        Swap,
+        PollEvents,
+        Count
+    };
+
+    struct StageStats
+    {
+        size_t samples = 0;
+        double mean = 0;
+        double p50 = 0;
+        double p95 = 0;
+        double p99 = 0;
+        double max = 0;
+    };
+
+    // Mean, percentiles and maximum of a set of timings, or of counts as double to keep them exact
+    template <typename T>
+    StageStats summarize(std::vector<T> values)
+    {
+        StageStats s;
+        s.samples = values.size();
+        if (values.empty())
+        {
+            return s;
+        }
+
+        std::sort(values.begin(), values.end());
+        const auto percentile = [&values](double p)
+        {
+            const auto index = static_cast<size_t>(std::ceil(p * values.size())) - 1;
+            return static_cast<double>(values[std::min(index, values.size() - 1)]);
+        };
+
+        double sum = 0;
+        for (const auto v : values)
+        {
+            sum += v;
+        }
+        s.mean = sum / values.size();
+        s.p50 = percentile(0.50);
+        s.p95 = percentile(0.95);
+        s.p99 = percentile(0.99);
+        s.max = values.back();
+        return s;
+    }
+
+    // Records per-frame timings (in milliseconds) of every channel into a fixed ring of frames.
+    // The render thread is the single writer; stats() and dumpCsv() may be called from any thread and
+    // never block it, each ring slot being guarded by a sequence counter. Frames and stages are also emitted
+    // as trace events while the TraceWriter is running.
+    class FrameProfiler
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+        static constexpr size_t maxChannels = 32;
+        // returned by addChannel() once every channel is taken, recording to it does nothing
+        static constexpr size_t noChannel = static_cast<size_t>(-1);
+
+        class ScopedStage
+        {
+        private:
+            FrameProfiler &_profiler;
+            size_t _channel;
+            const char *_traceName = nullptr;
+            Clock::time_point _start;
+
+        public:
+            ScopedStage(FrameProfiler &profiler, size_t channel) :
+                _profiler(profiler), _channel(channel)
+            {
+                if (TraceWriter::enabled() && _channel != noChannel)
+                {
+                    _traceName = _profiler._names[_channel].c_str();
+                    TraceWriter::instance().begin(_traceName);
+                }
+                _start = Clock::now();
+            }
+            ScopedStage(const ScopedStage &) = delete;
+            ScopedStage &operator=(const ScopedStage &) = delete;
+            ~ScopedStage()
+            {
+                _profiler.record(_channel, std::chrono::duration<double, std::milli>(Clock::now() - _start).count());
+                if (_traceName)
+                {
+                    TraceWriter::instance().end(_traceName);
+                }
+            }
+        };
+
+    private:
+        struct Slot
+        {
+            std::atomic<uint64_t> sequence{0};
+            std::atomic<uint64_t> frame{0};
+            std::array<std::atomic<float>, maxChannels> values{};
+        };
+
+        std::unique_ptr<Slot[]> _slots;
+        size_t _capacity;
+        std::atomic<uint64_t> _published{0};
+
+        // a deque keeps the names in place, trace events refer to them by pointer
+        std::deque<std::string> _names;
+        std::array<float, maxChannels> _current{};
+        Clock::time_point _frameStart;
+        Clock::time_point _reportStart;
+        int _reportFrames = 0;
+        double _fps = 0;
+
+    public:
+        explicit FrameProfiler(size_t capacity = 1024) :
+            _slots(new Slot[capacity]), _capacity(capacity),
+            _names{"total", "update", "upload", "draw", "swap", "poll"},
+            _frameStart(Clock::now()), _reportStart(_frameStart)
+        {
+        }
+
+        FrameProfiler(const FrameProfiler &) = delete;
+        FrameProfiler &operator=(const FrameProfiler &) = delete;
+
+        // Registers an extra channel, call during setup before frames are recorded. Returns noChannel when
+        // all maxChannels are taken, so the extra timings are left out instead of landing in another channel.
+        size_t addChannel(const std::string &name)
+        {
+            if (_names.size() == maxChannels)
+            {
+                return noChannel;
+            }
+            _names.push_back(name);
+            return _names.size() - 1;
+        }
+
+        [[nodiscard]] size_t channelCount() const
+        {
+            return _names.size();
+        }
+
+        [[nodiscard]] const std::string &channelName(size_t channel) const
+        {
+            return _names[channel];
+        }
+
+        void beginFrame()
+        {
+            _current.fill(0.0f);
+            _frameStart = Clock::now();
+            if (TraceWriter::enabled())
+            {
+                TraceWriter::instance().begin("frame", static_cast<int64_t>(frameCount()));
+            }
+        }
+
+        // Adds time to a channel of the current frame, repeated stages within a frame accumulate
+        void record(size_t channel, double ms)
+        {
+            if (channel == noChannel)
+            {
+                return;
+            }
+            _current[channel] += static_cast<float>(ms);
+        }
+
+        void record(Stage stage, double ms)
+        {
+            record(static_cast<size_t>(stage), ms);
+        }
+
+        [[nodiscard]] ScopedStage scope(size_t channel)
+        {
+            return ScopedStage(*this, channel);
+        }
+
+        [[nodiscard]] ScopedStage scope(Stage stage)
+        {
+            return ScopedStage(*this, static_cast<size_t>(stage));
+        }
+
+        void endFrame()
+        {
+            const auto now = Clock::now();
+            _current[static_cast<size_t>(Stage::Frame)] =
+                std::chrono::duration<float, std::milli>(now - _frameStart).count();
+
+            const uint64_t frame = _published.load(std::memory_order_relaxed);
+            Slot &slot = _slots[frame % _capacity];
+
+            slot.sequence.store(2 * frame + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.frame.store(frame, std::memory_order_relaxed);
+            for (size_t i = 0; i < maxChannels; i++)
+            {
+                slot.values[i].store(_current[i], std::memory_order_relaxed);
+            }
+            slot.sequence.store(2 * frame + 2, std::memory_order_release);
+            _published.store(frame + 1, std::memory_order_release);
+
+            _reportFrames++;
+
+            if (TraceWriter::enabled())
+            {
+                TraceWriter::instance().end("frame");
+            }
+        }
+
+        // True once per interval, the frame rate over that interval is then available from fps()
+        bool reportDue(std::chrono::nanoseconds interval = std::chrono::seconds(1))
+        {
+            const auto now = Clock::now();
+            const auto elapsed = now - _reportStart;
+            if (elapsed < interval)
+            {
+                return false;
+            }
+            _fps = _reportFrames / std::chrono::duration<double>(elapsed).count();
+            _reportFrames = 0;
+            _reportStart = now;
+            return true;
+        }
+
+        [[nodiscard]] double fps() const
+        {
+            return _fps;
+        }
+
+        [[nodiscard]] uint64_t frameCount() const
+        {
+            return _published.load(std::memory_order_acquire);
+        }
+
+        struct FrameRecord
+        {
+            uint64_t frame;
+            std::array<float, maxChannels> values;
+        };
+
+        // Copies the frames currently held in the ring, skipping slots that are being overwritten
+        [[nodiscard]] std::vector<FrameRecord> snapshot() const
+        {
+            std::vector<FrameRecord> out;
+            const uint64_t published = _published.load(std::memory_order_acquire);
+            const uint64_t first = published > _capacity ? published - _capacity : 0;
+            out.reserve(published - first);
+
+            for (uint64_t f = first; f < published; f++)
+            {
+                const Slot &slot = _slots[f % _capacity];
+                const uint64_t before = slot.sequence.load(std::memory_order_acquire);
+                if (before != 2 * f + 2)
+                {
+                    continue;
+                }
+
+                FrameRecord record;
+                record.frame = slot.frame.load(std::memory_order_relaxed);
+                for (size_t i = 0; i < maxChannels; i++)
+                {
+                    record.values[i] = slot.values[i].load(std::memory_order_relaxed);
+                }
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) == before)
+                {
+                    out.push_back(record);
+                }
+            }
+            return out;
+        }
+
+        [[nodiscard]] std::vector<float> samples(size_t channel) const
+        {
+            std::vector<float> out;
+            for (const auto &record : snapshot())
+            {
+                out.push_back(record.values[channel]);
+            }
+            return out;
+        }
+
+        [[nodiscard]] StageStats stats(size_t channel) const
+        {
+            return summarize(samples(channel));
+        }
+
+        [[nodiscard]] StageStats stats(Stage stage) const
+        {
+            return stats(static_cast<size_t>(stage));
+        }
+
+        // One line per channel with its percentiles over the frames in the ring
+        void print(std::ostream &os) const
+        {
+            os << "FPS: " << std::fixed << std::setprecision(1) << _fps << std::endl;
+            for (size_t i = 0; i < _names.size(); i++)
+            {
+                const auto s = stats(i);
+                os << "  " << std::left << std::setw(16) << _names[i] << std::right << std::setprecision(3)
+                   << " p50 " << std::setw(8) << s.p50 << " p95 " << std::setw(8) << s.p95 << " p99 "
+                   << std::setw(8) << s.p99 << " max " << std::setw(8) << s.max << " ms" << std::endl;
+            }
+            os << std::defaultfloat << std::setprecision(6);
+        }
+
+        // Writes the frames held in the ring as CSV, one row per frame and one column per channel in ms
+        bool dumpCsv(const std::string &path) const
+        {
+            std::ofstream file(path);
+            if (!file)
+            {
+                return false;
+            }
+
+            file << "frame";
+            for (const auto &name : _names)
+            {
+                file << "," << name;
+            }
+            file << "\n";
+
+            for (const auto &record : snapshot())
+            {
+                file << record.frame;
+                for (size_t i = 0; i < _names.size(); i++)
+                {
+                    file << "," << record.values[i];
+                }
+                file << "\n";
+            }
+            return static_cast<bool>(file);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef CPPPLOT_RESOURCE_POOL_H
+#define CPPPLOT_RESOURCE_POOL_H
+
+#include "shader.h"
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace cppplot
+{
+    // GL objects created once and used by every canvas of a share group: shader programs, static vertex
+    // buffers and lookup textures, each keyed by name. Create and destroy the pool with a context of the
+    // group current, e.g. the first canvas, and keep it alive while the other canvases draw.
+    class ResourcePool
+    {
+    private:
+        ShaderManager _shaders;
+        std::unordered_map<std::string, GLuint> _buffers;
+        std::unordered_map<std::string, GLuint> _textures;
+        size_t _bufferBytes = 0;
+        size_t _textureBytes = 0;
+
+    public:
+        explicit ResourcePool(std::string shaderCacheDir = "shader_cache") :
+            _shaders(std::move(shaderCacheDir))
+        {
+        }
+
+        ResourcePool(const ResourcePool &) = delete;
+        ResourcePool &operator=(const ResourcePool &) = delete;
+
+        ~ResourcePool()
+        {
+            for (const auto &[name, buffer] : _buffers)
+            {
+                glDeleteBuffers(1, &buffer);
+            }
+            for (const auto &[name, texture] : _textures)
+            {
+                glDeleteTextures(1, &texture);
+            }
+        }
+
+        [[nodiscard]] ShaderManager &shaders()
+        {
+            return _shaders;
+        }
+
+        // The GL_STATIC_DRAW buffer called name, filled from data on first use; later calls ignore data
+        GLuint staticBuffer(const std::string &name, const void *data, size_t bytes)
+        {
+            const auto found = _buffers.find(name);
+            if (found != _buffers.end())
+            {
+                return found->second;
+            }
+
+            GLuint buffer;
+            glGenBuffers(1, &buffer);
+            glBindBuffer(GL_ARRAY_BUFFER, buffer);
+            glBufferData(GL_ARRAY_BUFFER, bytes, data, GL_STATIC_DRAW);
+            _bufferBytes += bytes;
+            _buffers[name] = buffer;
+            return buffer;
+        }
+
+        // The RGB8 1D texture called name with size texels, linear filtering and clamped ends, e.g. a colormap
+        GLuint texture1D(const std::string &name, const uint8_t *rgb, int size)
+        {
+            const auto found = _textures.find(name);
+            if (found != _textures.end())
+            {
+                return found->second;
+            }
+
+            GLuint texture;
+            glGenTextures(1, &texture);
+            glBindTexture(GL_TEXTURE_1D, texture);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glTexImage1D(GL_TEXTURE_1D, 0, GL_RGB8, size, 0, GL_RGB, GL_UNSIGNED_BYTE, rgb);
+            glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            _textureBytes += static_cast<size_t>(size) * 4;
+            _textures[name] = texture;
+            return texture;
+        }
+
+        // Bytes of buffer and texture storage requested by the pool, textures counted at 4 bytes per texel
+        [[nodiscard]] size_t bufferBytes() const
+        {
+            return _bufferBytes;
+        }
+
+        [[nodiscard]] size_t textureBytes() const
+        {
+            return _textureBytes;
+        }
+    };
+
+    // Vertex array object of one canvas. VAOs are containers and are never shared between contexts, so
+    // each canvas of a share group keeps its own, pointing at the pool's buffers.
+    class VertexArray
+    {
+    private:
+        GLuint _vao = 0;
+
+    public:
+        // Created and left bound in the current context
+        VertexArray()
+        {
+            glGenVertexArrays(1, &_vao);
+            glBindVertexArray(_vao);
+        }
+
+        VertexArray(const VertexArray &) = delete;
+        VertexArray &operator=(const VertexArray &) = delete;
+
+        // Needs the context that created it to be current
+        ~VertexArray()
+        {
+            glDeleteVertexArrays(1, &_vao);
+        }
+
+        void bind() const
+        {
+            glBindVertexArray(_vao);
+        }
+
+        [[nodiscard]] GLuint id() const
+        {
+            return _vao;
+        }
+    };
+
+    // Dedicated video memory still available in KB, from GL_NVX_gpu_memory_info or GL_ATI_meminfo; -1 when
+    // the driver reports neither
+    inline long availableVideoMemoryKb()
+    {
+        if (GLEW_NVX_gpu_memory_info)
+        {
+            GLint kb = 0;
+            glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &kb);
+            return kb;
+        }
+        if (GLEW_ATI_meminfo)
+        {
+            GLint info[4] = {};
+            glGetIntegerv(GL_VBO_FREE_MEMORY_ATI, info);
+            return info[0];
+        }
+        return -1;
+    }
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef CPPPLOT_SCENE_H
+#define CPPPLOT_SCENE_H
+
+#include "axis_transform.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cppplot
+{
+    enum class SeriesKind
+    {
+        // consecutive vertices joined, restarting every stripLength vertices like one glDrawArrays per line
+        LineStrip,
+        // squares of half-size size pixels centred on the vertices, like PointShape<Shape::Square>
+        Points,
+        // rectangles from baseline to each y, size data units wide and centred on x
+        Bars
+    };
+
+    struct Color
+    {
+        uint8_t r = 255;
+        uint8_t g = 255;
+        uint8_t b = 255;
+    };
+
+    // Data of one series, referenced and not copied: interleaved x, y positions in data units, the layout
+    // the plot's vertex buffers use, and optionally 3 uint8 RGB per vertex as in a SeriesColor buffer
+    struct Series
+    {
+        SeriesKind kind = SeriesKind::LineStrip;
+        const float *xy = nullptr;
+        size_t count = 0;
+        size_t stripLength = 0;
+        const uint8_t *rgb = nullptr;
+        Color color;
+        float size = 1.0f;
+        float baseline = 0.0f;
+    };
+
+    // What a plot draws, independent of the renderer: the axes mapping data units to the image, as
+    // AxisTransforms applies them on the GPU, and the series in drawing order
+    struct Scene
+    {
+        int width = 0;
+        int height = 0;
+        Color background{26, 26, 26};
+        Axis x;
+        Axis y;
+        std::vector<Series> series;
+    };
+}
+
+#endif
@@ -0,0 +1,309 @@
+#ifndef CPPPLOT_SHADER_H
+#define CPPPLOT_SHADER_H
+
+#include <GL/glew.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cppplot
+{
+    inline uint64_t hashString(const std::string &text, uint64_t hash = 0xcbf29ce484222325ull)
+    {
+        for (const unsigned char c : text)
+        {
+            hash = (hash ^ c) * 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    // Builds and owns the shader programs of a GL context. Programs are keyed by their sources, so plots
+    // asking for the same shaders share one program. Linked programs are saved with glGetProgramBinary to
+    // cacheDir, under a name hashing the sources and the GL vendor, renderer and version; the file repeats
+    // the driver string and the sources, so a name collision is a cache miss rather than a foreign binary.
+    // The next start loads the binary instead of compiling and falls back to compiling when the file is
+    // unreadable or the driver rejects it. An empty cacheDir disables the disk cache.
+    class ShaderManager
+    {
+    private:
+        std::string _cacheDir;
+        std::string _driver;
+        std::unordered_map<std::string, GLuint> _programs;
+        size_t _compiled = 0;
+        size_t _loaded = 0;
+        size_t _shared = 0;
+
+        static constexpr uint32_t fileVersion = 2;
+
+        static GLuint compile(GLenum type, const std::string &source)
+        {
+            const auto shader = glCreateShader(type);
+            const GLchar *sourcePtr = source.c_str();
+            glShaderSource(shader, 1, &sourcePtr, nullptr);
+            glCompileShader(shader);
+
+            GLint success;
+            glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+            if (!success)
+            {
+                GLchar infoLog[512];
+                glGetShaderInfoLog(shader, sizeof(infoLog), nullptr, infoLog);
+                glDeleteShader(shader);
+                throw std::runtime_error(std::string(type == GL_VERTEX_SHADER ? "Vertex" : "Fragment") +
+                                         " shader compilation failed\n" + infoLog);
+            }
+            return shader;
+        }
+
+        std::string cachePath(const std::string &sources) const
+        {
+            char name[32];
+            std::snprintf(name, sizeof(name), "%016llx.bin",
+                          static_cast<unsigned long long>(hashString(_driver, hashString(sources))));
+            return (std::filesystem::path(_cacheDir) / name).string();
+        }
+
+        // Reads a length-prefixed string, refusing lengths past the end of the file
+        static bool readString(std::FILE *file, uintmax_t &remaining, std::string &text)
+        {
+            uint32_t length = 0;
+            if (remaining < sizeof(length) || std::fread(&length, sizeof(length), 1, file) != 1)
+            {
+                return false;
+            }
+            remaining -= sizeof(length);
+            if (length > remaining)
+            {
+                return false;
+            }
+            text.resize(length);
+            remaining -= length;
+            return std::fread(text.data(), 1, length, file) == length;
+        }
+
+        static void writeString(std::FILE *file, const std::string &text)
+        {
+            const auto length = static_cast<uint32_t>(text.size());
+            std::fwrite(&length, sizeof(length), 1, file);
+            std::fwrite(text.data(), 1, text.size(), file);
+        }
+
+        // A missing, truncated or foreign file, or one too large to hold in memory, is a cache miss
+        GLuint load(const std::string &sources) const
+        {
+            const auto path = cachePath(sources);
+            std::error_code error;
+            uintmax_t remaining = std::filesystem::file_size(path, error);
+            if (error)
+            {
+                return 0;
+            }
+            std::FILE *file = std::fopen(path.c_str(), "rb");
+            if (!file)
+            {
+                return 0;
+            }
+
+            uint32_t header[2] = {};
+            std::string driver;
+            std::string stored;
+            std::string binary;
+            bool ok = false;
+            try
+            {
+                ok = remaining >= sizeof(header) && std::fread(header, sizeof(uint32_t), 2, file) == 2 &&
+                     header[0] == fileVersion;
+                remaining -= ok ? sizeof(header) : 0;
+                ok = ok && readString(file, remaining, driver) && driver == _driver;
+                ok = ok && readString(file, remaining, stored) && stored == sources;
+                ok = ok && readString(file, remaining, binary) && !binary.empty();
+            }
+            catch (const std::bad_alloc &)
+            {
+                ok = false;
+            }
+            std::fclose(file);
+            if (!ok)
+            {
+                return 0;
+            }
+
+            const auto program = glCreateProgram();
+            glProgramBinary(program, header[1], binary.data(), static_cast<GLsizei>(binary.size()));
+            GLint success = GL_FALSE;
+            glGetProgramiv(program, GL_LINK_STATUS, &success);
+            if (!success)
+            {
+                glDeleteProgram(program);
+                return 0;
+            }
+            return program;
+        }
+
+        // Writes a temporary file and renames it over the cache file, so a concurrent start never reads a
+        // half-written binary
+        void store(const std::string &sources, GLuint program) const
+        {
+            GLint length = 0;
+            glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+            if (length <= 0)
+            {
+                return;
+            }
+            std::string binary(static_cast<size_t>(length), '\0');
+            GLenum format = 0;
+            glGetProgramBinary(program, length, nullptr, &format, binary.data());
+
+            std::error_code error;
+            std::filesystem::create_directories(_cacheDir, error);
+            const auto path = cachePath(sources);
+            char suffix[48];
+            std::snprintf(suffix, sizeof(suffix), ".%llx.%llx.tmp",
+                          static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(this)),
+                          static_cast<unsigned long long>(std::chrono::steady_clock::now().time_since_epoch().count()));
+            const auto temporary = path + suffix;
+            std::FILE *file = std::fopen(temporary.c_str(), "wb");
+            if (!file)
+            {
+                return;
+            }
+            const uint32_t header[2] = {fileVersion, format};
+            std::fwrite(header, sizeof(uint32_t), 2, file);
+            writeString(file, _driver);
+            writeString(file, sources);
+            writeString(file, binary);
+            const bool written = !std::ferror(file);
+            if (std::fclose(file) == 0 && written)
+            {
+                std::filesystem::rename(temporary, path, error);
+            }
+            else
+            {
+                error = std::make_error_code(std::errc::io_error);
+            }
+            if (error)
+            {
+                std::filesystem::remove(temporary, error);
+            }
+        }
+
+    public:
+        // Needs a current GL context; drivers without program binary formats only get the in-memory sharing
+        explicit ShaderManager(std::string cacheDir = "shader_cache") :
+            _cacheDir(std::move(cacheDir))
+        {
+            GLint formats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+            if (formats == 0)
+            {
+                _cacheDir.clear();
+            }
+            for (const GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION})
+            {
+                const auto *value = reinterpret_cast<const char *>(glGetString(name));
+                _driver += value ? value : "";
+                _driver += '\n';
+            }
+        }
+
+        ShaderManager(const ShaderManager &) = delete;
+        ShaderManager &operator=(const ShaderManager &) = delete;
+
+        ~ShaderManager()
+        {
+            for (const auto &[key, program] : _programs)
+            {
+                glDeleteProgram(program);
+            }
+        }
+
+        // Returns the linked program for the sources, throws std::runtime_error with the info log on failure
+        GLuint program(const std::string &vertexSource, const std::string &fragmentSource)
+        {
+            // the vertex source cannot hold a NUL, so the key separates the two sources unambiguously
+            std::string key = vertexSource;
+            key += '\0';
+            key += fragmentSource;
+            const auto found = _programs.find(key);
+            if (found != _programs.end())
+            {
+                _shared++;
+                return found->second;
+            }
+
+            GLuint program = _cacheDir.empty() ? 0 : load(key);
+            if (program)
+            {
+                _loaded++;
+                _programs.emplace(std::move(key), program);
+                return program;
+            }
+
+            const auto vertexShader = compile(GL_VERTEX_SHADER, vertexSource);
+            GLuint fragmentShader = 0;
+            try
+            {
+                fragmentShader = compile(GL_FRAGMENT_SHADER, fragmentSource);
+            }
+            catch (...)
+            {
+                glDeleteShader(vertexShader);
+                throw;
+            }
+
+            program = glCreateProgram();
+            if (!_cacheDir.empty())
+            {
+                glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+            }
+            glAttachShader(program, vertexShader);
+            glAttachShader(program, fragmentShader);
+            glLinkProgram(program);
+            glDetachShader(program, vertexShader);
+            glDetachShader(program, fragmentShader);
+            glDeleteShader(vertexShader);
+            glDeleteShader(fragmentShader);
+
+            GLint success;
+            glGetProgramiv(program, GL_LINK_STATUS, &success);
+            if (!success)
+            {
+                char infoLog[512];
+                glGetProgramInfoLog(program, sizeof(infoLog), nullptr, infoLog);
+                glDeleteProgram(program);
+                throw std::runtime_error(std::string("Program linking failed\n") + infoLog);
+            }
+
+            _compiled++;
+            if (!_cacheDir.empty())
+            {
+                store(key, program);
+            }
+            _programs.emplace(std::move(key), program);
+            return program;
+        }
+
+        // Programs built from source, loaded from the disk cache, and requests served by an existing program
+        [[nodiscard]] size_t compiled() const
+        {
+            return _compiled;
+        }
+
+        [[nodiscard]] size_t loaded() const
+        {
+            return _loaded;
+        }
+
+        [[nodiscard]] size_t shared() const
+        {
+            return _shared;
+        }
+    };
+}
+
+#endif
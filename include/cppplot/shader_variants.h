@@ -0,0 +1,412 @@
+#ifndef CPPPLOT_SHADER_VARIANTS_H
+#define CPPPLOT_SHADER_VARIANTS_H
+
+#include "shader.h"
+#include <GL/glew.h>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace cppplot
+{
+    // Plot features used as template arguments of ShaderVariant. Each feature contributes GLSL snippets at
+    // a fixed stage of the vertex position pipeline, attribute flags, and a Uniforms mixin holding the
+    // locations and setters of its uniforms, so a variant only carries what its features need. Snippets
+    // are emitted in stage order, not template argument order, so permutations of the same features
+    // produce identical sources and share one program through the ShaderManager.
+    namespace feature
+    {
+        // vertex attribute locations shared by all variants
+        constexpr GLuint positionLocation = 1;
+        constexpr GLuint colorLocation = 2;
+        // shader storage binding of the positions read by Segments variants
+        constexpr GLuint pointsBinding = 0;
+
+        enum Flags : unsigned
+        {
+            // aPos and aColor advance per instance, the quad corner comes from gl_VertexID
+            Instanced = 1,
+            // aPos is uint16 normalized to [0, 1] instead of float
+            Quantized = 2,
+            // aColor is a per-vertex uint8 RGB attribute
+            VertexColor = 4,
+            // the fragment output is the uint ID of the vertex or instance instead of a colour
+            IdOutput = 8,
+            // one instance per line segment reading its end points and neighbours from the points storage
+            // buffer; the stage code becomes the function plotPosition() and the feature's segmentCode
+            // computes pos in main() instead
+            Segments = 16,
+            // aColor is one value per vertex of the feature's valueType, which its colorCode turns into vColor
+            ScalarValue = 32,
+        };
+
+        enum Stage
+        {
+            Decode,
+            Transform,
+            Expand,
+            Project,
+            Shift,
+            Layout,
+            StageCount
+        };
+
+        // distinct per feature, a variant cannot inherit the same base twice
+        template <typename Feature>
+        struct NoUniforms
+        {
+            void locate(GLuint)
+            {
+            }
+        };
+
+        // Defaults for the members a feature does not override
+        struct Base
+        {
+            static constexpr unsigned flags = 0;
+            static constexpr int stage = Transform;
+            static constexpr const char *vertexDeclarations = "";
+            static constexpr const char *vertexCode = "";
+            static constexpr const char *fragmentDeclarations = "";
+            static constexpr const char *fragmentCode = "";
+            static constexpr const char *segmentCode = "";
+            static constexpr const char *colorCode = "";
+            static constexpr GLenum valueType = 0;
+        };
+    }
+
+    // Scrolls the plot left by uShift, as the roll plot does
+    struct TimeShift : feature::Base
+    {
+        static constexpr int stage = feature::Shift;
+        static constexpr const char *vertexDeclarations = "uniform float uShift;\n";
+        static constexpr const char *vertexCode = "    pos.x -= uShift;\n";
+
+        class Uniforms
+        {
+        private:
+            GLint _shift = -1;
+
+        public:
+            void locate(GLuint program)
+            {
+                _shift = glGetUniformLocation(program, "uShift");
+            }
+
+            void setShift(float shift) const
+            {
+                glUniform1f(_shift, shift);
+            }
+        };
+    };
+
+    // Positions stored as uint16 in [0, 65535] mapped to [-1, 1], half the bytes of float positions
+    struct QuantizedInput : feature::Base
+    {
+        static constexpr unsigned flags = feature::Quantized;
+        static constexpr int stage = feature::Decode;
+        static constexpr const char *vertexCode = "    pos = pos * 2.0 - 1.0;\n";
+        using Uniforms = feature::NoUniforms<QuantizedInput>;
+
+        static uint16_t quantize(float value)
+        {
+            const float clamped = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+            return static_cast<uint16_t>((clamped + 1.0f) * 32767.5f + 0.5f);
+        }
+    };
+
+    // Logarithmic y axis, values in [min, max] of setLogRange map to [-1, 1]
+    struct LogScale : feature::Base
+    {
+        static constexpr int stage = feature::Transform;
+        static constexpr const char *vertexDeclarations = "uniform vec2 uLogRange;\n";
+        static constexpr const char *vertexCode =
+            "    pos.y = (log2(max(pos.y, 1e-30)) - uLogRange.x) / (uLogRange.y - uLogRange.x) * 2.0 - 1.0;\n";
+
+        class Uniforms
+        {
+        private:
+            GLint _range = -1;
+
+        public:
+            void locate(GLuint program)
+            {
+                _range = glGetUniformLocation(program, "uLogRange");
+            }
+
+            void setLogRange(float min, float max) const
+            {
+                glUniform2f(_range, std::log2(min), std::log2(max));
+            }
+        };
+    };
+
+    // Colour per vertex (per point for instanced shapes) from a uint8 RGB attribute
+    struct SeriesColor : feature::Base
+    {
+        static constexpr unsigned flags = feature::VertexColor;
+        static constexpr const char *vertexDeclarations = "layout (location = 2) in vec3 aColor;\n";
+        using Uniforms = feature::NoUniforms<SeriesColor>;
+    };
+
+    // Single colour for the whole plot
+    struct UniformColor : feature::Base
+    {
+        static constexpr const char *vertexDeclarations = "uniform vec3 uColor;\n";
+
+        class Uniforms
+        {
+        private:
+            GLint _color = -1;
+
+        public:
+            void locate(GLuint program)
+            {
+                _color = glGetUniformLocation(program, "uColor");
+            }
+
+            void setColor(float r, float g, float b) const
+            {
+                glUniform3f(_color, r, g, b);
+            }
+        };
+    };
+
+    // Renders 1 + the index of the vertex (instance for instanced shapes) into an R32UI attachment, 0
+    // being the background, for picking with IdPicker. Lines report the last vertex of the segment hit.
+    struct PickId : feature::Base
+    {
+        static constexpr unsigned flags = feature::IdOutput;
+        using Uniforms = feature::NoUniforms<PickId>;
+    };
+
+    // Scale matrix and offset applied after the data transforms, e.g. the aspect ratio correction
+    struct Scale : feature::Base
+    {
+        static constexpr int stage = feature::Project;
+        static constexpr const char *vertexDeclarations = "uniform mat2 uScale;\nuniform vec2 uOffset;\n";
+        static constexpr const char *vertexCode = "    pos = uScale * pos + uOffset;\n";
+
+        class Uniforms
+        {
+        private:
+            GLint _scale = -1;
+            GLint _offset = -1;
+
+        public:
+            void locate(GLuint program)
+            {
+                _scale = glGetUniformLocation(program, "uScale");
+                _offset = glGetUniformLocation(program, "uOffset");
+            }
+
+            // column-major 2x2 matrix
+            void setScale(const float (&matrix)[4]) const
+            {
+                glUniformMatrix2fv(_scale, 1, GL_FALSE, matrix);
+            }
+
+            void setOffset(float x, float y) const
+            {
+                glUniform2f(_offset, x, y);
+            }
+        };
+    };
+
+    enum class Shape
+    {
+        Square,
+        Circle,
+        Diamond
+    };
+
+    // Instanced markers: every point is a quad of half-size uSize in clip space drawn from 4 corners
+    // indexed by gl_VertexID. Square needs no fragment work, the other shapes discard outside the marker.
+    template <Shape S>
+    struct PointShape : feature::Base
+    {
+        static constexpr unsigned flags = feature::Instanced;
+        static constexpr int stage = feature::Expand;
+        static constexpr const char *vertexDeclarations =
+            S == Shape::Square ? "uniform vec2 uSize;\n"
+                               : "uniform vec2 uSize;\nout vec2 vCorner;\n";
+        static constexpr const char *vertexCode =
+            S == Shape::Square
+                ? "    const vec2 corners[4] = vec2[4](vec2(-1.0, 1.0), vec2(1.0, 1.0), vec2(-1.0, -1.0), vec2(1.0, -1.0));\n"
+                  "    pos += uSize * corners[gl_VertexID];\n"
+                : "    const vec2 corners[4] = vec2[4](vec2(-1.0, 1.0), vec2(1.0, 1.0), vec2(-1.0, -1.0), vec2(1.0, -1.0));\n"
+                  "    vCorner = corners[gl_VertexID];\n"
+                  "    pos += uSize * vCorner;\n";
+        static constexpr const char *fragmentDeclarations = S == Shape::Square ? "" : "in vec2 vCorner;\n";
+        static constexpr const char *fragmentCode =
+            S == Shape::Circle    ? "    if (dot(vCorner, vCorner) > 1.0) discard;\n"
+            : S == Shape::Diamond ? "    if (abs(vCorner.x) + abs(vCorner.y) > 1.0) discard;\n"
+                                  : "";
+
+        class Uniforms
+        {
+        private:
+            GLint _size = -1;
+
+        public:
+            void locate(GLuint program)
+            {
+                _size = glGetUniformLocation(program, "uSize");
+            }
+
+            // aspect (height / width of the viewport) keeps markers square on screen
+            void setSize(float size, float aspect = 1.0f) const
+            {
+                glUniform2f(_size, size * aspect, size);
+            }
+        };
+    };
+
+    // Shader program specialised for a set of plot features. The GLSL is generated from the features,
+    // the uniform setters are inherited from them (setShift() only exists on variants with TimeShift),
+    // and setupAttributes() matches the attribute formats the generated shader expects.
+    template <typename... Features>
+    class ShaderVariant : public Features::Uniforms...
+    {
+    private:
+        template <typename F>
+        static constexpr int count = (0 + ... + std::is_same_v<F, Features>);
+        static_assert(((count<Features> == 1) && ...), "ShaderVariant features must be unique");
+
+        GLuint _program = 0;
+
+    public:
+        static constexpr unsigned flags = (0u | ... | Features::flags);
+        static constexpr bool instanced = flags & feature::Instanced;
+        static constexpr bool quantized = flags & feature::Quantized;
+        static constexpr bool vertexColor = flags & feature::VertexColor;
+        static constexpr bool idOutput = flags & feature::IdOutput;
+        static constexpr bool segments = flags & feature::Segments;
+        static constexpr bool scalarValue = flags & feature::ScalarValue;
+        static_assert(!(segments && quantized), "Segments variants read float positions");
+        static_assert(!(vertexColor && (std::is_same_v<Features, UniformColor> || ...)),
+                      "SeriesColor and UniformColor are exclusive");
+        static_assert(!(scalarValue && (vertexColor || (std::is_same_v<Features, UniformColor> || ...))),
+                      "a scalar colour excludes SeriesColor and UniformColor");
+
+        // GL type of the scalar colour values
+        static constexpr GLenum valueType = (0u | ... | Features::valueType);
+
+        // element type of the position buffer
+        using Position = std::conditional_t<quantized, uint16_t, float>;
+
+        template <typename F>
+        static constexpr bool has = (std::is_same_v<F, Features> || ...);
+
+        static std::string vertexSource()
+        {
+            std::string source = segments ? "#version 430 core\nlayout (std430, binding = 0) readonly buffer Points\n{\n    vec2 points[];\n};\n"
+                                          : "#version 330 core\nlayout (location = 1) in vec2 aPos;\n";
+            for (int stage = 0; stage < feature::StageCount; stage++)
+            {
+                ((source += Features::stage == stage ? Features::vertexDeclarations : ""), ...);
+            }
+            source += idOutput ? "flat out uint vId;\n" : "";
+            source += segments ? "out vec3 vColor;\n\nvec2 plotPosition(vec2 pos)\n{\n"
+                               : "out vec3 vColor;\n\nvoid main()\n{\n    vec2 pos = aPos;\n";
+            for (int stage = 0; stage < feature::StageCount; stage++)
+            {
+                ((source += Features::stage == stage ? Features::vertexCode : ""), ...);
+            }
+            if constexpr (segments)
+            {
+                source += "    return pos;\n}\n\nvoid main()\n{\n";
+                ((source += Features::segmentCode), ...);
+            }
+            source += "    gl_Position = vec4(pos, 0.0, 1.0);\n";
+            if constexpr (idOutput)
+            {
+                source += segments    ? "    vId = uint(segment + 1) + 1u;\n"
+                          : instanced ? "    vId = uint(gl_InstanceID) + 1u;\n"
+                                      : "    vId = uint(gl_VertexID) + 1u;\n";
+            }
+            if constexpr (vertexColor)
+            {
+                source += "    vColor = aColor;\n";
+            }
+            else if constexpr (has<UniformColor>)
+            {
+                source += "    vColor = uColor;\n";
+            }
+            else if constexpr (scalarValue)
+            {
+                ((source += Features::colorCode), ...);
+            }
+            else
+            {
+                source += "    vColor = vec3(1.0);\n";
+            }
+            return source + "}\n";
+        }
+
+        static std::string fragmentSource()
+        {
+            std::string source = idOutput ? "#version 330 core\nin vec3 vColor;\nflat in uint vId;\nout uint FragId;\n"
+                                          : "#version 330 core\nin vec3 vColor;\nout vec4 FragColor;\n";
+            for (int stage = 0; stage < feature::StageCount; stage++)
+            {
+                ((source += Features::stage == stage ? Features::fragmentDeclarations : ""), ...);
+            }
+            source += "\nvoid main()\n{\n";
+            for (int stage = 0; stage < feature::StageCount; stage++)
+            {
+                ((source += Features::stage == stage ? Features::fragmentCode : ""), ...);
+            }
+            return source + (idOutput   ? "    FragId = vId;\n}\n"
+                             : segments ? "    FragColor = vec4(vColor, coverage);\n}\n"
+                                        : "    FragColor = vec4(vColor, 0.7);\n}\n");
+        }
+
+        explicit ShaderVariant(ShaderManager &shaders) :
+            _program(shaders.program(vertexSource(), fragmentSource()))
+        {
+            (Features::Uniforms::locate(_program), ...);
+        }
+
+        [[nodiscard]] GLuint program() const
+        {
+            return _program;
+        }
+
+        void use() const
+        {
+            glUseProgram(_program);
+        }
+
+        // Points the attributes of the bound VAO at the buffers: positionBuffer holds 2 Position values per
+        // vertex, colorBuffer 3 uint8 per vertex, or one valueType value with a scalar colour (ignored without
+        // either). Leaves positionBuffer bound.
+        // Segments variants read positionBuffer as the points storage buffer instead, a binding of the
+        // context rather than the VAO.
+        void setupAttributes(GLuint positionBuffer, GLuint colorBuffer = 0) const
+        {
+            if constexpr (vertexColor || scalarValue)
+            {
+                glBindBuffer(GL_ARRAY_BUFFER, colorBuffer);
+                glVertexAttribPointer(feature::colorLocation, vertexColor ? 3 : 1, vertexColor ? GL_UNSIGNED_BYTE : valueType,
+                                      valueType == GL_FLOAT ? GL_FALSE : GL_TRUE, 0, (void *)0);
+                glVertexAttribDivisor(feature::colorLocation, instanced ? 1 : 0);
+                glEnableVertexAttribArray(feature::colorLocation);
+            }
+
+            glBindBuffer(GL_ARRAY_BUFFER, positionBuffer);
+            if constexpr (segments)
+            {
+                glBindBufferBase(GL_SHADER_STORAGE_BUFFER, feature::pointsBinding, positionBuffer);
+                return;
+            }
+            glVertexAttribPointer(feature::positionLocation, 2, quantized ? GL_UNSIGNED_SHORT : GL_FLOAT,
+                                  quantized ? GL_TRUE : GL_FALSE, 0, (void *)0);
+            glVertexAttribDivisor(feature::positionLocation, instanced ? 1 : 0);
+            glEnableVertexAttribArray(feature::positionLocation);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,341 @@
+#ifndef CPPPLOT_SOFT_RASTER_H
+#define CPPPLOT_SOFT_RASTER_H
+
+#include "parallel.h"
+#include "scene.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace cppplot
+{
+    // CPU renderer of a Scene for machines without any GL driver. Lines are drawn with Wu's anti-aliased
+    // algorithm, points and bars as rectangles with exact pixel coverage at their edges. Each series is
+    // transformed to pixels and its primitives binned into 64px tiles by all threads, every thread taking
+    // a contiguous range of primitives and keeping its own bins, then the tiles are rasterised in parallel;
+    // a tile walks the bins in thread order, so primitives overlap in drawing order as on the GPU and no
+    // two threads ever write the same pixel.
+    class SoftRasterizer
+    {
+    public:
+        static constexpr int tileSize = 64;
+
+    private:
+        struct Tile
+        {
+            int x0;
+            int y0;
+            int x1;
+            int y1;
+        };
+
+        size_t _threads;
+        int _width = 0;
+        int _height = 0;
+        int _tilesX = 0;
+        int _tilesY = 0;
+        std::vector<uint8_t> _rgba;
+        // vertex positions in pixels for lines, x0, y0, x1, y1 rectangles for points and bars
+        std::vector<float> _pixels;
+        // primitive indices per binning thread and tile
+        std::vector<std::vector<std::vector<uint32_t>>> _bins;
+
+        [[nodiscard]] Tile tile(size_t index) const
+        {
+            const int tx = static_cast<int>(index % _tilesX);
+            const int ty = static_cast<int>(index / _tilesX);
+            return {tx * tileSize, ty * tileSize, std::min(_width, (tx + 1) * tileSize), std::min(_height, (ty + 1) * tileSize)};
+        }
+
+        static Color colorOf(const Series &series, size_t vertex)
+        {
+            if (!series.rgb)
+            {
+                return series.color;
+            }
+            const uint8_t *c = series.rgb + vertex * 3;
+            return {c[0], c[1], c[2]};
+        }
+
+        void blend(int x, int y, Color c, float coverage)
+        {
+            uint8_t *p = _rgba.data() + (static_cast<size_t>(y) * _width + x) * 4;
+            const int a = static_cast<int>(coverage * 256.0f);
+            p[0] = static_cast<uint8_t>(p[0] + (((c.r - p[0]) * a) >> 8));
+            p[1] = static_cast<uint8_t>(p[1] + (((c.g - p[1]) * a) >> 8));
+            p[2] = static_cast<uint8_t>(p[2] + (((c.b - p[2]) * a) >> 8));
+        }
+
+        // Wu's line between pixel centres, restricted to the pixels of tile t. Like GL line strips the end
+        // vertex is left to the next segment unless includeEnd, so joints are not blended twice.
+        void drawSegment(float x0, float y0, float x1, float y1, Color c, const Tile &t, bool includeEnd)
+        {
+            bool skipFirst = false;
+            bool skipLast = !includeEnd;
+            const bool steep = std::fabs(y1 - y0) > std::fabs(x1 - x0);
+            if (steep)
+            {
+                std::swap(x0, y0);
+                std::swap(x1, y1);
+            }
+            if (x0 > x1)
+            {
+                std::swap(x0, x1);
+                std::swap(y0, y1);
+                std::swap(skipFirst, skipLast);
+            }
+            const float gradient = x1 > x0 ? (y1 - y0) / (x1 - x0) : 0.0f;
+
+            // the major axis only walks across the tile, the minor axis is checked per pixel
+            const int majorBegin = steep ? t.y0 : t.x0;
+            const int majorEnd = steep ? t.y1 : t.x1;
+            const int minorBegin = steep ? t.x0 : t.y0;
+            const int minorEnd = steep ? t.x1 : t.y1;
+            const int first = static_cast<int>(std::max(std::round(x0) + skipFirst, static_cast<float>(majorBegin)));
+            const int last = static_cast<int>(std::min(std::round(x1) - skipLast, static_cast<float>(majorEnd - 1)));
+
+            for (int major = first; major <= last; major++)
+            {
+                const float minor = y0 + gradient * (major - x0);
+                const float below = std::floor(minor);
+                if (below < minorBegin - 1 || below >= minorEnd)
+                {
+                    continue;
+                }
+                const float fraction = minor - below;
+                const int m = static_cast<int>(below);
+                if (m >= minorBegin && m < minorEnd)
+                {
+                    steep ? blend(m, major, c, 1.0f - fraction) : blend(major, m, c, 1.0f - fraction);
+                }
+                if (m + 1 >= minorBegin && m + 1 < minorEnd)
+                {
+                    steep ? blend(m + 1, major, c, fraction) : blend(major, m + 1, c, fraction);
+                }
+            }
+        }
+
+        // Rectangle in pixel coordinates, pixel i covering [i - 0.5, i + 0.5], restricted to tile t
+        void fillRect(float x0, float y0, float x1, float y1, Color c, const Tile &t)
+        {
+            const int left = std::max(t.x0, static_cast<int>(std::floor(std::max(x0 + 0.5f, -1.0f))));
+            const int right = std::min(t.x1 - 1, static_cast<int>(std::floor(std::min(x1 + 0.5f, static_cast<float>(_width)))));
+            const int top = std::max(t.y0, static_cast<int>(std::floor(std::max(y0 + 0.5f, -1.0f))));
+            const int bottom = std::min(t.y1 - 1, static_cast<int>(std::floor(std::min(y1 + 0.5f, static_cast<float>(_height)))));
+
+            for (int y = top; y <= bottom; y++)
+            {
+                const float coverY = std::min(y1, y + 0.5f) - std::max(y0, y - 0.5f);
+                for (int x = left; x <= right; x++)
+                {
+                    const float coverX = std::min(x1, x + 0.5f) - std::max(x0, x - 0.5f);
+                    const float coverage = coverX * coverY;
+                    if (coverage > 0.0f)
+                    {
+                        blend(x, y, c, std::min(coverage, 1.0f));
+                    }
+                }
+            }
+        }
+
+        void transform(const Scene &scene, const Series &series)
+        {
+            const float xLow = scene.x.scaled(scene.x.domainMin);
+            const float yLow = scene.y.scaled(scene.y.domainMin);
+            const float xFactor = (scene.x.rangeMax - scene.x.rangeMin) / (scene.x.scaled(scene.x.domainMax) - xLow);
+            const float yFactor = (scene.y.rangeMax - scene.y.rangeMin) / (scene.y.scaled(scene.y.domainMax) - yLow);
+            // clip space to pixel centres, y down
+            const auto pixelX = [&](float v)
+            { return (scene.x.rangeMin + (scene.x.scaled(v) - xLow) * xFactor + 1.0f) * 0.5f * _width - 0.5f; };
+            const auto pixelY = [&](float v)
+            { return (1.0f - scene.y.rangeMin - (scene.y.scaled(v) - yLow) * yFactor) * 0.5f * _height - 0.5f; };
+
+            const size_t stride = series.kind == SeriesKind::LineStrip ? 2 : 4;
+            _pixels.resize(series.count * stride);
+            parallelFor(series.count, _threads, [&](size_t, size_t begin, size_t end)
+                        {
+                            for (size_t i = begin; i < end; i++)
+                            {
+                                const float x = series.xy[i * 2];
+                                const float y = series.xy[i * 2 + 1];
+                                float *out = _pixels.data() + i * stride;
+                                if (series.kind == SeriesKind::LineStrip)
+                                {
+                                    out[0] = pixelX(x);
+                                    out[1] = pixelY(y);
+                                }
+                                else if (series.kind == SeriesKind::Points)
+                                {
+                                    const float px = pixelX(x);
+                                    const float py = pixelY(y);
+                                    out[0] = px - series.size;
+                                    out[1] = py - series.size;
+                                    out[2] = px + series.size;
+                                    out[3] = py + series.size;
+                                }
+                                else
+                                {
+                                    const float left = pixelX(x - series.size * 0.5f);
+                                    const float right = pixelX(x + series.size * 0.5f);
+                                    const float top = pixelY(y);
+                                    const float base = pixelY(series.baseline);
+                                    out[0] = std::min(left, right);
+                                    out[1] = std::min(top, base);
+                                    out[2] = std::max(left, right);
+                                    out[3] = std::max(top, base);
+                                }
+                            } });
+        }
+
+        // Pixel bounds of primitive i, false when there is no such primitive (a strip restart)
+        [[nodiscard]] bool bounds(const Series &series, size_t i, float &x0, float &y0, float &x1, float &y1) const
+        {
+            if (series.kind == SeriesKind::LineStrip)
+            {
+                if (series.stripLength && (i + 1) % series.stripLength == 0)
+                {
+                    return false;
+                }
+                const float *p = _pixels.data() + i * 2;
+                x0 = std::min(p[0], p[2]) - 1.0f;
+                x1 = std::max(p[0], p[2]) + 1.0f;
+                y0 = std::min(p[1], p[3]) - 1.0f;
+                y1 = std::max(p[1], p[3]) + 1.0f;
+                return true;
+            }
+            const float *p = _pixels.data() + i * 4;
+            x0 = p[0] - 0.5f;
+            y0 = p[1] - 0.5f;
+            x1 = p[2] + 0.5f;
+            y1 = p[3] + 0.5f;
+            return true;
+        }
+
+        void bin(const Series &series, size_t primitives)
+        {
+            for (auto &bins : _bins)
+            {
+                for (auto &tileBin : bins)
+                {
+                    tileBin.clear();
+                }
+            }
+
+            parallelFor(primitives, _threads, [&](size_t chunk, size_t begin, size_t end)
+                        {
+                            auto &bins = _bins[chunk];
+                            for (size_t i = begin; i < end; i++)
+                            {
+                                float x0, y0, x1, y1;
+                                // also skips NaN positions
+                                if (!bounds(series, i, x0, y0, x1, y1) || !(x1 >= 0.0f && y1 >= 0.0f && x0 < _width && y0 < _height))
+                                {
+                                    continue;
+                                }
+                                const int tx0 = static_cast<int>(std::max(x0, 0.0f)) / tileSize;
+                                const int ty0 = static_cast<int>(std::max(y0, 0.0f)) / tileSize;
+                                const int tx1 = std::min(_tilesX - 1, static_cast<int>(std::min(x1, static_cast<float>(_width))) / tileSize);
+                                const int ty1 = std::min(_tilesY - 1, static_cast<int>(std::min(y1, static_cast<float>(_height))) / tileSize);
+                                for (int ty = ty0; ty <= ty1; ty++)
+                                {
+                                    for (int tx = tx0; tx <= tx1; tx++)
+                                    {
+                                        bins[static_cast<size_t>(ty) * _tilesX + tx].push_back(static_cast<uint32_t>(i));
+                                    }
+                                }
+                            } });
+        }
+
+        void rasterize(const Series &series)
+        {
+            parallelFor(_bins.front().size(), _threads, [&](size_t, size_t begin, size_t end)
+                        {
+                            for (size_t index = begin; index < end; index++)
+                            {
+                                const Tile t = tile(index);
+                                for (const auto &bins : _bins)
+                                {
+                                    for (const uint32_t i : bins[index])
+                                    {
+                                        if (series.kind == SeriesKind::LineStrip)
+                                        {
+                                            const float *p = _pixels.data() + static_cast<size_t>(i) * 2;
+                                            const bool includeEnd = i + 2 == series.count || (series.stripLength && (i + 2) % series.stripLength == 0);
+                                            drawSegment(p[0], p[1], p[2], p[3], colorOf(series, i), t, includeEnd);
+                                        }
+                                        else
+                                        {
+                                            const float *p = _pixels.data() + static_cast<size_t>(i) * 4;
+                                            fillRect(p[0], p[1], p[2], p[3], colorOf(series, i), t);
+                                        }
+                                    }
+                                }
+                            } });
+        }
+
+    public:
+        // threads == 0 uses every hardware thread
+        explicit SoftRasterizer(size_t threads = 0) :
+            _threads(threads ? threads : hardwareThreads()), _bins(_threads)
+        {
+        }
+
+        // Draws the scene and returns its RGBA8 pixels, top row first like Canvas::readPixels(). The image
+        // stays valid until the next call.
+        const std::vector<uint8_t> &render(const Scene &scene)
+        {
+            if (scene.width != _width || scene.height != _height)
+            {
+                _width = scene.width;
+                _height = scene.height;
+                _tilesX = (_width + tileSize - 1) / tileSize;
+                _tilesY = (_height + tileSize - 1) / tileSize;
+                for (auto &bins : _bins)
+                {
+                    bins.assign(static_cast<size_t>(_tilesX) * _tilesY, {});
+                }
+            }
+
+            _rgba.resize(static_cast<size_t>(_width) * _height * 4);
+            const Color bg = scene.background;
+            parallelFor(static_cast<size_t>(_height), _threads, [&](size_t, size_t begin, size_t end)
+                        {
+                            for (size_t i = begin * _width; i < end * _width; i++)
+                            {
+                                _rgba[i * 4] = bg.r;
+                                _rgba[i * 4 + 1] = bg.g;
+                                _rgba[i * 4 + 2] = bg.b;
+                                _rgba[i * 4 + 3] = 255;
+                            } });
+            if (_width == 0 || _height == 0)
+            {
+                return _rgba;
+            }
+
+            for (const auto &series : scene.series)
+            {
+                if (series.count == 0)
+                {
+                    continue;
+                }
+                transform(scene, series);
+                bin(series, series.kind == SeriesKind::LineStrip ? series.count - 1 : series.count);
+                rasterize(series);
+            }
+            return _rgba;
+        }
+
+        [[nodiscard]] int width() const
+        {
+            return _width;
+        }
+
+        [[nodiscard]] int height() const
+        {
+            return _height;
+        }
+    };
+}
+
+#endif
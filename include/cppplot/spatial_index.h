@@ -0,0 +1,201 @@
+#ifndef CPPPLOT_SPATIAL_INDEX_H
+#define CPPPLOT_SPATIAL_INDEX_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace cppplot
+{
+    // Uniform grid over the points of a ring buffer, for hover picking. push() mirrors the plot's ring:
+    // points are written at consecutive slots and, once the ring is full, overwrite the oldest ones, which
+    // leave the grid at the same time. Each cell keeps its points in a list ordered oldest first, so the
+    // point being evicted is always the head of its cell's list and updates cost O(1) per point.
+    //
+    // Memory is 12 bytes per slot (a position copy and a list link) plus 8 bytes per cell. Points outside
+    // the bounds are kept in the border cells, queries stay exact but slow down if many points are there.
+    class SpatialIndex
+    {
+    public:
+        static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+        struct Hit
+        {
+            // ring slot, the instance index of the point in the plot's buffers
+            uint32_t index;
+            float x;
+            float y;
+            float distance;
+        };
+
+    private:
+        size_t _capacity;
+        size_t _size = 0;
+        size_t _next = 0;
+        float _xMin;
+        float _yMin;
+        float _cellWidth;
+        float _cellHeight;
+        int _cellsX;
+        int _cellsY;
+
+        std::vector<float> _points;
+        // per slot, the next newer point in the same cell
+        std::vector<uint32_t> _links;
+        // per cell, oldest and newest point
+        std::vector<uint32_t> _heads;
+        std::vector<uint32_t> _tails;
+
+        [[nodiscard]] int column(float x) const
+        {
+            const float c = (x - _xMin) / _cellWidth;
+            // also maps NaN to the first column
+            return c > 0.0f ? (c < _cellsX - 1 ? static_cast<int>(c) : _cellsX - 1) : 0;
+        }
+
+        [[nodiscard]] int row(float y) const
+        {
+            const float r = (y - _yMin) / _cellHeight;
+            return r > 0.0f ? (r < _cellsY - 1 ? static_cast<int>(r) : _cellsY - 1) : 0;
+        }
+
+        [[nodiscard]] size_t cellOf(size_t slot) const
+        {
+            return static_cast<size_t>(row(_points[slot * 2 + 1])) * _cellsX + column(_points[slot * 2]);
+        }
+
+        void evict(size_t slot)
+        {
+            const size_t cell = cellOf(slot);
+            _heads[cell] = _links[slot];
+            if (_heads[cell] == none)
+            {
+                _tails[cell] = none;
+            }
+        }
+
+        void insert(size_t slot, float x, float y)
+        {
+            _points[slot * 2] = x;
+            _points[slot * 2 + 1] = y;
+            _links[slot] = none;
+
+            const size_t cell = cellOf(slot);
+            if (_tails[cell] == none)
+            {
+                _heads[cell] = static_cast<uint32_t>(slot);
+            }
+            else
+            {
+                _links[_tails[cell]] = static_cast<uint32_t>(slot);
+            }
+            _tails[cell] = static_cast<uint32_t>(slot);
+        }
+
+    public:
+        // Square-ish cells sized for about pointsPerCell points each when the ring is full and the points
+        // are spread over [xMin, xMax] x [yMin, yMax]
+        SpatialIndex(size_t capacity, float xMin, float xMax, float yMin, float yMax, float pointsPerCell = 8.0f) :
+            _capacity(capacity), _xMin(xMin), _yMin(yMin),
+            _points(capacity * 2), _links(capacity, none)
+        {
+            const double width = std::max(xMax - xMin, 1e-30f);
+            const double height = std::max(yMax - yMin, 1e-30f);
+            const double cells = std::max(1.0, capacity / static_cast<double>(pointsPerCell));
+            const double side = std::sqrt(width * height / cells);
+            _cellsX = static_cast<int>(std::clamp(std::ceil(width / side), 1.0, 65536.0));
+            _cellsY = static_cast<int>(std::clamp(std::ceil(height / side), 1.0, 65536.0));
+            _cellWidth = static_cast<float>(width / _cellsX);
+            _cellHeight = static_cast<float>(height / _cellsY);
+            _heads.assign(static_cast<size_t>(_cellsX) * _cellsY, none);
+            _tails.assign(_heads.size(), none);
+        }
+
+        // Appends count points of interleaved x, y at the write position, wrapping like the plot's ring
+        void push(const float *xy, size_t count)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                if (_size == _capacity)
+                {
+                    evict(_next);
+                }
+                else
+                {
+                    _size++;
+                }
+                insert(_next, xy[i * 2], xy[i * 2 + 1]);
+                _next = _next + 1 == _capacity ? 0 : _next + 1;
+            }
+        }
+
+        void clear()
+        {
+            _size = 0;
+            _next = 0;
+            std::fill(_heads.begin(), _heads.end(), none);
+            std::fill(_tails.begin(), _tails.end(), none);
+        }
+
+        // Nearest point within radius of (x, y), if any
+        [[nodiscard]] std::optional<Hit> pick(float x, float y, float radius) const
+        {
+            const int c0 = column(x - radius);
+            const int c1 = column(x + radius);
+            const int r0 = row(y - radius);
+            const int r1 = row(y + radius);
+
+            uint32_t best = none;
+            float bestDistance2 = radius * radius;
+            for (int r = r0; r <= r1; r++)
+            {
+                for (int c = c0; c <= c1; c++)
+                {
+                    for (uint32_t i = _heads[static_cast<size_t>(r) * _cellsX + c]; i != none; i = _links[i])
+                    {
+                        const float dx = _points[i * 2] - x;
+                        const float dy = _points[i * 2 + 1] - y;
+                        const float d2 = dx * dx + dy * dy;
+                        if (d2 <= bestDistance2)
+                        {
+                            bestDistance2 = d2;
+                            best = i;
+                        }
+                    }
+                }
+            }
+
+            if (best == none)
+            {
+                return std::nullopt;
+            }
+            return Hit{best, _points[best * 2], _points[best * 2 + 1], std::sqrt(bestDistance2)};
+        }
+
+        [[nodiscard]] size_t size() const
+        {
+            return _size;
+        }
+
+        [[nodiscard]] size_t capacity() const
+        {
+            return _capacity;
+        }
+
+        [[nodiscard]] size_t cellCount() const
+        {
+            return _heads.size();
+        }
+
+        [[nodiscard]] size_t memoryBytes() const
+        {
+            return _points.size() * sizeof(float) + (_links.size() + _heads.size() + _tails.size()) * sizeof(uint32_t);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,169 @@
+#ifndef CPPPLOT_SUBPLOTS_H
+#define CPPPLOT_SUBPLOTS_H
+
+#include "shader.h"
+#include "shader_variants.h"
+#include <GL/glew.h>
+#include <stdexcept>
+#include <vector>
+
+namespace cppplot
+{
+    // Places every subplot of a grid from the per-subplot transforms of a SubplotLayout. Vertices are
+    // stored subplot after subplot, verticesPerPlot each, so the subplot index is gl_VertexID divided by
+    // it and all subplots draw in one glMultiDrawArrays call. Plot coordinates in [-1, 1] map to the
+    // subplot rectangle; clip distances cut what falls outside it (enable GL_CLIP_DISTANCE0 to 3).
+    struct Subplots : feature::Base
+    {
+        static constexpr int stage = feature::Layout;
+        static constexpr const char *vertexDeclarations =
+            "layout (std140) uniform SubplotBlock { vec4 uSubplots[1024]; };\n"
+            "uniform int uVerticesPerPlot;\n"
+            "out float gl_ClipDistance[4];\n";
+        static constexpr const char *vertexCode =
+            "    vec4 subplot = uSubplots[gl_VertexID / uVerticesPerPlot];\n"
+            "    gl_ClipDistance[0] = 1.0 + pos.x;\n"
+            "    gl_ClipDistance[1] = 1.0 - pos.x;\n"
+            "    gl_ClipDistance[2] = 1.0 + pos.y;\n"
+            "    gl_ClipDistance[3] = 1.0 - pos.y;\n"
+            "    pos = pos * subplot.xy + subplot.zw;\n";
+
+        class Uniforms
+        {
+        private:
+            GLuint _program = 0;
+            GLint _verticesPerPlot = -1;
+
+        public:
+            void locate(GLuint program)
+            {
+                _program = program;
+                _verticesPerPlot = glGetUniformLocation(program, "uVerticesPerPlot");
+            }
+
+            // Reads the transforms from the layout's binding point, call with the program in use
+            void setLayout(GLuint bindingPoint, int verticesPerPlot) const
+            {
+                glUniformBlockBinding(_program, glGetUniformBlockIndex(_program, "SubplotBlock"), bindingPoint);
+                glUniform1i(_verticesPerPlot, verticesPerPlot);
+            }
+        };
+    };
+
+    // rows x cols grid of subplots in one window. The transform of each subplot (scale and offset from its
+    // [-1, 1] plot coordinates to clip space) lives in a uniform buffer, so changing the layout is a
+    // single buffer update and drawing needs no per-subplot state. Subplots are numbered row by row from
+    // the top left. drawFrames() outlines every subplot in one instanced call.
+    class SubplotLayout
+    {
+    public:
+        // 1024 vec4 fill the 16 KB every GL implementation guarantees for a uniform block
+        static constexpr int maxSubplots = 1024;
+
+    private:
+        int _rows = 0;
+        int _cols = 0;
+        float _gap;
+        GLuint _ubo = 0;
+        GLuint _bindingPoint;
+        GLuint _frameProgram = 0;
+        GLuint _frameVao = 0;
+        GLint _frameColor = -1;
+        std::vector<float> _transforms;
+
+    public:
+        // gap is the space between subplots as a fraction of the window
+        SubplotLayout(ShaderManager &shaders, int rows, int cols, float gap = 0.01f, GLuint bindingPoint = 0) :
+            _gap(gap), _bindingPoint(bindingPoint)
+        {
+            glGenBuffers(1, &_ubo);
+            glBindBuffer(GL_UNIFORM_BUFFER, _ubo);
+            glBufferData(GL_UNIFORM_BUFFER, maxSubplots * 4 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+            glBindBufferBase(GL_UNIFORM_BUFFER, _bindingPoint, _ubo);
+
+            _frameProgram = shaders.program(R"(
+                #version 330 core
+                layout (std140) uniform SubplotBlock { vec4 uSubplots[1024]; };
+                void main()
+                {
+                    const vec2 corners[4] = vec2[4](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0));
+                    vec4 subplot = uSubplots[gl_InstanceID];
+                    gl_Position = vec4(corners[gl_VertexID] * subplot.xy + subplot.zw, 0.0, 1.0);
+                }
+            )",
+                                            R"(
+                #version 330 core
+                uniform vec3 uColor;
+                out vec4 FragColor;
+                void main()
+                {
+                    FragColor = vec4(uColor, 1.0);
+                }
+            )");
+            glUniformBlockBinding(_frameProgram, glGetUniformBlockIndex(_frameProgram, "SubplotBlock"), _bindingPoint);
+            _frameColor = glGetUniformLocation(_frameProgram, "uColor");
+            // core profile draws need a bound VAO even without attributes
+            glGenVertexArrays(1, &_frameVao);
+
+            resize(rows, cols);
+        }
+
+        SubplotLayout(const SubplotLayout &) = delete;
+        SubplotLayout &operator=(const SubplotLayout &) = delete;
+
+        ~SubplotLayout()
+        {
+            glDeleteVertexArrays(1, &_frameVao);
+            glDeleteBuffers(1, &_ubo);
+        }
+
+        void resize(int rows, int cols)
+        {
+            if (rows * cols > maxSubplots || rows <= 0 || cols <= 0)
+            {
+                throw std::runtime_error("Subplot grid must have between 1 and 1024 cells");
+            }
+            _rows = rows;
+            _cols = cols;
+
+            const float width = (2.0f - _gap * 2.0f * (cols + 1)) / cols;
+            const float height = (2.0f - _gap * 2.0f * (rows + 1)) / rows;
+            _transforms.resize(static_cast<size_t>(rows) * cols * 4);
+            for (int r = 0; r < rows; r++)
+            {
+                for (int c = 0; c < cols; c++)
+                {
+                    float *t = &_transforms[(r * cols + c) * 4];
+                    t[0] = width / 2.0f;
+                    t[1] = height / 2.0f;
+                    t[2] = -1.0f + _gap * 2.0f * (c + 1) + width * (c + 0.5f);
+                    t[3] = 1.0f - _gap * 2.0f * (r + 1) - height * (r + 0.5f);
+                }
+            }
+            glBindBuffer(GL_UNIFORM_BUFFER, _ubo);
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, _transforms.size() * sizeof(float), _transforms.data());
+        }
+
+        [[nodiscard]] int count() const
+        {
+            return _rows * _cols;
+        }
+
+        [[nodiscard]] GLuint bindingPoint() const
+        {
+            return _bindingPoint;
+        }
+
+        // Outline of every subplot, one instanced draw with clip distances disabled; leaves the frame program
+        // and its VAO bound
+        void drawFrames(float r, float g, float b) const
+        {
+            glUseProgram(_frameProgram);
+            glUniform3f(_frameColor, r, g, b);
+            glBindVertexArray(_frameVao);
+            glDrawArraysInstanced(GL_LINE_LOOP, 0, 4, count());
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,212 @@
+#ifndef CPPPLOT_SYNTH_H
+#define CPPPLOT_SYNTH_H
+
+#include "parallel.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cppplot
+{
+    // Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"): 4 random uint32 as a
+    // pure function of a 128 bit counter and a 64 bit key, so any value can be generated on its own and
+    // a range can be split across threads without any state
+    struct Philox
+    {
+        static std::array<uint32_t, 4> block(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3, uint32_t k0, uint32_t k1)
+        {
+            for (int round = 0; round < 10; round++)
+            {
+                const uint64_t p0 = uint64_t(0xD2511F53u) * c0;
+                const uint64_t p1 = uint64_t(0xCD9E8D57u) * c2;
+                const uint32_t n0 = uint32_t(p1 >> 32) ^ c1 ^ k0;
+                const uint32_t n2 = uint32_t(p0 >> 32) ^ c3 ^ k1;
+                c1 = uint32_t(p1);
+                c3 = uint32_t(p0);
+                c0 = n0;
+                c2 = n2;
+                k0 += 0x9E3779B9u;
+                k1 += 0xBB67AE85u;
+            }
+            return {c0, c1, c2, c3};
+        }
+    };
+
+    // Synthetic data for the demos and benchmarks. Value i of a stream comes from the Philox block of
+    // counter (i / values per block, stream) under the seed, so a fill gives the same numbers on any
+    // number of threads, a stream can be continued or regenerated from any offset, and separate streams
+    // (e.g. one per series or per frame) never overlap. Blocks are generated in batches by a branch-free
+    // loop the compiler vectorizes, and large fills are split across threads.
+    class Synth
+    {
+    private:
+        static constexpr size_t batch = 64;
+        // smaller fills stay on the calling thread, e.g. a frame's new points
+        static constexpr size_t parallelMinimum = 1 << 16;
+        // random walks are summed in blocks of this many steps, independent of the thread count
+        static constexpr size_t walkBlock = 1 << 16;
+
+        uint32_t _k0;
+        uint32_t _k1;
+        size_t _threads;
+
+        void blocks(uint32_t *out, uint64_t first, size_t count, uint64_t stream) const
+        {
+            const uint32_t s0 = static_cast<uint32_t>(stream);
+            const uint32_t s1 = static_cast<uint32_t>(stream >> 32);
+            for (size_t b = 0; b < count; b++)
+            {
+                const uint64_t counter = first + b;
+                const auto r = Philox::block(static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32), s0, s1, _k0, _k1);
+                out[b * 4] = r[0];
+                out[b * 4 + 1] = r[1];
+                out[b * 4 + 2] = r[2];
+                out[b * 4 + 3] = r[3];
+            }
+        }
+
+        // fn(i, block, slot) for value i of [0, count), slot being which of the perBlock values of its
+        // block it is
+        template <typename Fn>
+        void fill(size_t count, uint64_t offset, unsigned perBlock, uint64_t stream, Fn fn) const
+        {
+            parallelFor(count, count < parallelMinimum ? 1 : _threads, [&](size_t, size_t begin, size_t end)
+                        {
+                            uint32_t buffer[batch * 4];
+                            size_t i = begin;
+                            while (i < end)
+                            {
+                                const uint64_t first = (offset + i) / perBlock;
+                                const uint64_t needed = (offset + end - 1) / perBlock - first + 1;
+                                const size_t n = static_cast<size_t>(std::min<uint64_t>(batch, needed));
+                                blocks(buffer, first, n, stream);
+                                const size_t last = static_cast<size_t>(std::min<uint64_t>(end, (first + n) * perBlock - offset));
+                                for (; i < last; i++)
+                                {
+                                    const uint64_t value = offset + i;
+                                    fn(i, buffer + (value / perBlock - first) * 4, static_cast<unsigned>(value % perBlock));
+                                }
+                            }
+                        });
+        }
+
+        // [0, 1) from the top 24 bits
+        static float unit(uint32_t bits)
+        {
+            return (bits >> 8) * (1.0f / 16777216.0f);
+        }
+
+        // standard normal from two uniform words, Box-Muller
+        static float gaussian(uint32_t a, uint32_t b)
+        {
+            const float u1 = ((a >> 8) + 1) * (1.0f / 16777216.0f);
+            return std::sqrt(-2.0f * std::log(u1)) * std::cos(6.2831853f * unit(b));
+        }
+
+    public:
+        // threads == 0 uses every hardware thread for large fills
+        explicit Synth(uint64_t seed = 1, size_t threads = 0) :
+            _k0(static_cast<uint32_t>(seed)), _k1(static_cast<uint32_t>(seed >> 32)), _threads(threads)
+        {
+        }
+
+        // 32 random bits, value index of the stream
+        [[nodiscard]] uint32_t bits(uint64_t index, uint64_t stream = 0) const
+        {
+            uint32_t block[4];
+            blocks(block, index / 4, 1, stream);
+            return block[index % 4];
+        }
+
+        // count values uniform in [min, max)
+        void uniform(float *out, size_t count, float min, float max, uint64_t stream = 0, uint64_t offset = 0) const
+        {
+            fill(count, offset, 4, stream, [&](size_t i, const uint32_t *block, unsigned slot)
+                 { out[i] = min + (max - min) * unit(block[slot]); });
+        }
+
+        // count interleaved x, y points uniform in [xMin, xMax) x [yMin, yMax), the scatter workload
+        void uniformXy(float *xy, size_t count, float xMin, float xMax, float yMin, float yMax, uint64_t stream = 0,
+                       uint64_t offset = 0) const
+        {
+            fill(count, offset, 2, stream, [&](size_t i, const uint32_t *block, unsigned slot)
+                 {
+                     xy[i * 2] = xMin + (xMax - xMin) * unit(block[slot * 2]);
+                     xy[i * 2 + 1] = yMin + (yMax - yMin) * unit(block[slot * 2 + 1]);
+                 });
+        }
+
+        // count bytes uniform in [min, max], e.g. colours
+        void bytes(uint8_t *out, size_t count, uint8_t min = 0, uint8_t max = 255, uint64_t stream = 0, uint64_t offset = 0) const
+        {
+            const uint32_t range = uint32_t(max) - min + 1;
+            fill(count, offset, 4, stream, [&](size_t i, const uint32_t *block, unsigned slot)
+                 { out[i] = static_cast<uint8_t>(min + ((block[slot] >> 16) * range >> 16)); });
+        }
+
+        // count normally distributed values
+        void noise(float *out, size_t count, float mean = 0.0f, float sigma = 1.0f, uint64_t stream = 0, uint64_t offset = 0) const
+        {
+            fill(count, offset, 2, stream, [&](size_t i, const uint32_t *block, unsigned slot)
+                 { out[i] = mean + sigma * gaussian(block[slot * 2], block[slot * 2 + 1]); });
+        }
+
+        // amplitude * sin(2 pi frequency n + phase) for samples n = offset + i, frequency in cycles per
+        // sample, plus normal noise of standard deviation noise
+        void sine(float *out, size_t count, float frequency, float phase = 0.0f, float amplitude = 1.0f, float noise = 0.0f,
+                  uint64_t stream = 0, uint64_t offset = 0) const
+        {
+            fill(count, offset, 2, stream, [&](size_t i, const uint32_t *block, unsigned slot)
+                 {
+                     // the phase is reduced in double so long streams keep their precision
+                     const auto cycles = static_cast<float>(std::fmod(double(frequency) * double(offset + i), 1.0));
+                     out[i] = amplitude * std::sin(6.2831853f * cycles + phase) +
+                              (noise != 0.0f ? noise * gaussian(block[slot * 2], block[slot * 2 + 1]) : 0.0f);
+                 });
+        }
+
+        // start plus the running sum of count normal steps of standard deviation step, always from the
+        // first step of the stream
+        void randomWalk(float *out, size_t count, float step = 1.0f, float start = 0.0f, uint64_t stream = 0) const
+        {
+            noise(out, count, 0.0f, step, stream);
+            const size_t blockCount = (count + walkBlock - 1) / walkBlock;
+            std::vector<float> sums(blockCount);
+            parallelFor(blockCount, count < parallelMinimum ? 1 : _threads, [&](size_t, size_t begin, size_t end)
+                        {
+                            for (size_t b = begin; b < end; b++)
+                            {
+                                float sum = 0.0f;
+                                for (size_t i = b * walkBlock; i < std::min(count, (b + 1) * walkBlock); i++)
+                                {
+                                    sum += out[i];
+                                    out[i] = sum;
+                                }
+                                sums[b] = sum;
+                            }
+                        });
+            float carry = start;
+            for (auto &sum : sums)
+            {
+                const float blockSum = sum;
+                sum = carry;
+                carry += blockSum;
+            }
+            parallelFor(blockCount, count < parallelMinimum ? 1 : _threads, [&](size_t, size_t begin, size_t end)
+                        {
+                            for (size_t b = begin; b < end; b++)
+                            {
+                                for (size_t i = b * walkBlock; i < std::min(count, (b + 1) * walkBlock); i++)
+                                {
+                                    out[i] += sums[b];
+                                }
+                            }
+                        });
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef CPPPLOT_THICK_LINES_H
+#define CPPPLOT_THICK_LINES_H
+
+#include "shader_variants.h"
+#include <GL/glew.h>
+
+namespace cppplot
+{
+    // Anti-aliased lines of any width, which core profile GL_LINE_STRIP cannot draw. Each segment is one
+    // instance of a 4 vertex triangle strip: the vertex shader reads the segment's end points and their
+    // neighbours from the points storage buffer, runs them through the other features' stage code and
+    // expands the segment into a quad in pixel space, mitred against the neighbouring segments so
+    // consecutive quads share their edges and no pixel is blended twice. The quad is half a pixel wider on
+    // each side than the line and the fragment shader turns the distance from the centre line into alpha
+    // coverage, so GL_BLEND with GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA must be enabled. No vertices are
+    // generated on the CPU and the vertex buffer is used as it is; per vertex colours are read per
+    // instance, so a segment takes the colour of its first vertex. Stage code must not depend on
+    // gl_VertexID, which rules out Subplots.
+    struct ThickLines : feature::Base
+    {
+        static constexpr unsigned flags = feature::Instanced | feature::Segments;
+        static constexpr const char *vertexDeclarations =
+            "uniform float uLineWidth;\n"
+            "uniform vec2 uViewport;\n"
+            "uniform int uFirst;\n"
+            "uniform int uCount;\n"
+            "uniform int uStripLength;\n"
+            "noperspective out float vEdge;\n";
+        static constexpr const char *segmentCode =
+            "    int segment = uFirst + gl_InstanceID;\n"
+            "    int k = uStripLength > 0 ? segment % uStripLength : gl_InstanceID;\n"
+            "    int last = (uStripLength > 0 ? uStripLength : uCount) - 1;\n"
+            "    vec2 halfViewport = uViewport * 0.5;\n"
+            "    vec2 a = plotPosition(points[segment]) * halfViewport;\n"
+            "    vec2 b = plotPosition(points[k < last ? segment + 1 : segment]) * halfViewport;\n"
+            "    vec2 dir = b - a;\n"
+            "    float len = length(dir);\n"
+            "    dir = len > 0.0 ? dir / len : vec2(1.0, 0.0);\n"
+            "    vec2 normal = vec2(-dir.y, dir.x);\n"
+            "    bool atEnd = gl_VertexID >= 2;\n"
+            "    float side = (gl_VertexID & 1) == 0 ? -1.0 : 1.0;\n"
+            "    vec2 offset = normal;\n"
+            "    if (atEnd ? k + 1 < last : k > 0)\n"
+            "    {\n"
+            "        vec2 c = plotPosition(points[atEnd ? segment + 2 : segment - 1]) * halfViewport;\n"
+            "        vec2 other = atEnd ? c - b : a - c;\n"
+            "        float otherLen = length(other);\n"
+            "        vec2 miter = otherLen > 0.0 ? normal + vec2(-other.y, other.x) / otherLen : vec2(0.0);\n"
+            "        float miterLen = length(miter);\n"
+            "        if (miterLen > 1e-3)\n"
+            "        {\n"
+            "            miter /= miterLen;\n"
+            "            offset = miter / max(dot(miter, normal), 0.25);\n"
+            "        }\n"
+            "    }\n"
+            "    float halfWidth = uLineWidth * 0.5 + 0.5;\n"
+            "    vEdge = side * halfWidth;\n"
+            "    vec2 pos = k < last ? ((atEnd ? b : a) + side * halfWidth * offset) / halfViewport : vec2(-2.0);\n";
+        static constexpr const char *fragmentDeclarations = "uniform float uLineWidth;\nnoperspective in float vEdge;\n";
+        static constexpr const char *fragmentCode = "    float coverage = clamp(uLineWidth * 0.5 + 0.5 - abs(vEdge), 0.0, 1.0);\n";
+
+        class Uniforms
+        {
+        private:
+            GLint _lineWidth = -1;
+            GLint _viewport = -1;
+            GLint _first = -1;
+            GLint _count = -1;
+            GLint _stripLength = -1;
+
+        public:
+            void locate(GLuint program)
+            {
+                _lineWidth = glGetUniformLocation(program, "uLineWidth");
+                _viewport = glGetUniformLocation(program, "uViewport");
+                _first = glGetUniformLocation(program, "uFirst");
+                _count = glGetUniformLocation(program, "uCount");
+                _stripLength = glGetUniformLocation(program, "uStripLength");
+            }
+
+            // width in pixels of a framebuffer of viewportWidth x viewportHeight pixels
+            void setLineWidth(float width, int viewportWidth, int viewportHeight) const
+            {
+                glUniform1f(_lineWidth, width);
+                glUniform2f(_viewport, static_cast<float>(viewportWidth), static_cast<float>(viewportHeight));
+            }
+
+            // The equivalent of glDrawArrays(GL_LINE_STRIP, first, count), or of one such draw every
+            // stripLength vertices of the buffer when stripLength is not 0, with the program in use
+            void draw(GLint first, GLsizei count, GLint stripLength = 0) const
+            {
+                if (count < 2)
+                {
+                    return;
+                }
+                glUniform1i(_first, first);
+                glUniform1i(_count, count);
+                glUniform1i(_stripLength, stripLength);
+                glDrawArraysInstancedBaseInstance(GL_TRIANGLE_STRIP, 0, 4, count - 1, static_cast<GLuint>(first));
+            }
+        };
+    };
+}
+
+#endif
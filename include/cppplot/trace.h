@@ -0,0 +1,292 @@
+#ifndef CPPPLOT_TRACE_H
+#define CPPPLOT_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cppplot
+{
+    // Streams Chrome Trace Event JSON (viewable in chrome://tracing and Perfetto) to a file. Events are
+    // appended to a bounded buffer which a writer thread drains to disk; when both the active and the
+    // draining buffer are full, events are dropped instead of blocking the caller. While stopped, every
+    // trace point costs a single relaxed load and branch. Use TraceWriter::instance(), a single writer
+    // is active at a time.
+    class TraceWriter
+    {
+    private:
+        struct Event
+        {
+            const char *name;
+            char phase;
+            uint32_t tid;
+            int64_t ts;
+            int64_t value;
+        };
+
+        static inline std::atomic<bool> _enabled{false};
+        mutable std::mutex _mutex;
+        std::condition_variable _wake;
+        std::vector<Event> _active;
+        std::vector<Event> _draining;
+        size_t _capacity = 0;
+        bool _flushPending = false;
+        bool _stopping = false;
+        size_t _dropped = 0;
+        std::FILE *_file = nullptr;
+        bool _first = true;
+        std::thread _writer;
+        std::chrono::steady_clock::time_point _epoch;
+
+        static uint32_t threadId()
+        {
+            static std::atomic<uint32_t> next{1};
+            thread_local const uint32_t id = next++;
+            return id;
+        }
+
+        void push(const char *name, char phase, int64_t value)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            const uint32_t tid = threadId();
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            // a caller that passed enabled() before the trace stopped may arrive during the next one
+            if (_stopping || now < _epoch)
+            {
+                return;
+            }
+            const Event event = {name, phase, tid, std::chrono::duration_cast<std::chrono::nanoseconds>(now - _epoch).count(), value};
+            if (_active.size() == _capacity)
+            {
+                if (_flushPending)
+                {
+                    _dropped++;
+                    return;
+                }
+                std::swap(_active, _draining);
+                _flushPending = true;
+                _wake.notify_one();
+            }
+            _active.push_back(event);
+        }
+
+        // names may come from user strings, e.g. GPU pass names, so they are escaped as JSON strings
+        void writeName(const char *name)
+        {
+            for (const char *c = name; *c; c++)
+            {
+                const auto byte = static_cast<unsigned char>(*c);
+                if (byte == '"' || byte == '\\')
+                {
+                    std::fputc('\\', _file);
+                    std::fputc(byte, _file);
+                }
+                else if (byte < 0x20)
+                {
+                    std::fprintf(_file, "\\u%04x", byte);
+                }
+                else
+                {
+                    std::fputc(byte, _file);
+                }
+            }
+        }
+
+        void write(const std::vector<Event> &events)
+        {
+            for (const auto &e : events)
+            {
+                std::fprintf(_file, "%s\n{\"name\":\"", _first ? "" : ",");
+                writeName(e.name);
+                std::fprintf(_file, "\",\"ph\":\"%c\",\"ts\":%lld.%03lld,\"pid\":1,\"tid\":%u", e.phase,
+                             (long long)(e.ts / 1000), (long long)(e.ts % 1000), e.tid);
+                if (e.phase == 'C')
+                {
+                    std::fprintf(_file, ",\"args\":{\"value\":%lld}}", (long long)e.value);
+                }
+                else if (e.phase == 'B' && e.value >= 0)
+                {
+                    std::fprintf(_file, ",\"args\":{\"frame\":%lld}}", (long long)e.value);
+                }
+                else
+                {
+                    std::fputc('}', _file);
+                }
+                _first = false;
+            }
+        }
+
+        void writerLoop()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (true)
+            {
+                _wake.wait(lock, [this]
+                           { return _flushPending || _stopping; });
+                if (_flushPending)
+                {
+                    lock.unlock();
+                    write(_draining);
+                    lock.lock();
+                    _draining.clear();
+                    _flushPending = false;
+                }
+                else if (_stopping)
+                {
+                    return;
+                }
+            }
+        }
+
+    public:
+        TraceWriter() = default;
+        TraceWriter(const TraceWriter &) = delete;
+        TraceWriter &operator=(const TraceWriter &) = delete;
+
+        ~TraceWriter()
+        {
+            stop();
+        }
+
+        static TraceWriter &instance()
+        {
+            static TraceWriter writer;
+            return writer;
+        }
+
+        // Starts streaming to path, bufferEvents bounds the memory held by each of the two buffers
+        bool start(const std::string &path, size_t bufferEvents = 1 << 16)
+        {
+            stop();
+            _file = std::fopen(path.c_str(), "w");
+            if (!_file)
+            {
+                return false;
+            }
+            std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", _file);
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _capacity = bufferEvents;
+                _active.reserve(_capacity);
+                _draining.reserve(_capacity);
+                _first = true;
+                _dropped = 0;
+                _stopping = false;
+                _epoch = std::chrono::steady_clock::now();
+            }
+            _writer = std::thread(&TraceWriter::writerLoop, this);
+            _enabled.store(true, std::memory_order_relaxed);
+            return true;
+        }
+
+        void stop()
+        {
+            if (!_file)
+            {
+                return;
+            }
+            _enabled.store(false, std::memory_order_relaxed);
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stopping = true;
+                _wake.notify_one();
+            }
+            _writer.join();
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            write(_draining);
+            write(_active);
+            _draining.clear();
+            _active.clear();
+            std::fputs("\n]}\n", _file);
+            std::fclose(_file);
+            _file = nullptr;
+        }
+
+        // Constant-initialised, so trace points can test it without touching the writer instance
+        [[nodiscard]] static bool enabled()
+        {
+            return _enabled.load(std::memory_order_relaxed);
+        }
+
+        // Events lost because the writer could not keep up
+        [[nodiscard]] size_t dropped() const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _dropped;
+        }
+
+        // name must outlive the trace, string literals or otherwise stable storage
+        void begin(const char *name, int64_t frame = -1)
+        {
+            if (enabled())
+            {
+                push(name, 'B', frame);
+            }
+        }
+
+        void end(const char *name)
+        {
+            if (enabled())
+            {
+                push(name, 'E', 0);
+            }
+        }
+
+        void counter(const char *name, int64_t value)
+        {
+            if (enabled())
+            {
+                push(name, 'C', value);
+            }
+        }
+    };
+
+    class TraceScope
+    {
+    private:
+        const char *_name;
+
+    public:
+        explicit TraceScope(const char *name, int64_t frame = -1) :
+            _name(nullptr)
+        {
+            if (TraceWriter::enabled())
+            {
+                _name = name;
+                TraceWriter::instance().begin(name, frame);
+            }
+        }
+        TraceScope(const TraceScope &) = delete;
+        TraceScope &operator=(const TraceScope &) = delete;
+        ~TraceScope()
+        {
+            if (_name)
+            {
+                TraceWriter::instance().end(_name);
+            }
+        }
+    };
+}
+
+#define CPPPLOT_TRACE_CONCAT_(a, b) a##b
+#define CPPPLOT_TRACE_CONCAT(a, b) CPPPLOT_TRACE_CONCAT_(a, b)
+#define CPPPLOT_TRACE_SCOPE(name) const cppplot::TraceScope CPPPLOT_TRACE_CONCAT(traceScope, __LINE__)(name)
+#define CPPPLOT_TRACE_COUNTER(name, value)                            \
+    do                                                                \
+    {                                                                 \
+        if (cppplot::TraceWriter::enabled())                          \
+        {                                                             \
+            cppplot::TraceWriter::instance().counter(name, value);    \
+        }                                                             \
+    } while (false)
+
+#endif
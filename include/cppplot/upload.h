@@ -0,0 +1,33 @@
+#ifndef CPPPLOT_UPLOAD_H
+#define CPPPLOT_UPLOAD_H
+
+#include "dirty.h"
+#include <GL/glew.h>
+
+namespace cppplot
+{
+    // Uploads only the given byte ranges of data into the buffer bound to target. Returns the bytes sent.
+    inline size_t uploadRanges(GLenum target, const std::vector<Range> &ranges, const void *data)
+    {
+        const auto *bytes = static_cast<const char *>(data);
+        for (const auto &r : ranges)
+        {
+            glBufferSubData(target, r.begin, r.end - r.begin, bytes + r.begin);
+        }
+        return totalBytes(ranges);
+    }
+
+    // Uploads the dirty ranges of all series and clears them
+    inline size_t uploadDirty(GLenum target, std::vector<DirtyIntervals> &series, size_t seriesStride,
+                              size_t elementBytes, const void *data, size_t mergeGapBytes = 0)
+    {
+        const auto ranges = collectUploadRanges(series, seriesStride, elementBytes, mergeGapBytes);
+        for (auto &s : series)
+        {
+            s.clear();
+        }
+        return uploadRanges(target, ranges, data);
+    }
+}
+
+#endif
@@ -0,0 +1,229 @@
+#ifndef CPPPLOT_VIEW_CONTROLLER_H
+#define CPPPLOT_VIEW_CONTROLLER_H
+
+#include "axis_transform.h"
+#include "profiler.h"
+#include <GL/glew.h>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <glfwpp/glfwpp.h>
+#include <optional>
+#include <vector>
+
+namespace cppplot
+{
+    // Mouse pan and zoom of a plot's x and y axes: dragging with the left button pans, the scroll wheel
+    // zooms around the cursor and the middle button restores the initial view. Input only edits the axis
+    // domains, the plot applies them with AxisTransforms::setAxes once per frame when update() reports a
+    // change, so navigating costs a few uniforms whatever the number of points and no data is re-uploaded.
+    //
+    // Optionally measures input-to-photon latency: the time from the first input event of a view change to
+    // the GPU finishing the first frame presented with it, found by polling a fence placed after present()
+    // in later frames. Display scan-out after the swap is not included.
+    class ViewController
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+        static constexpr size_t latencyCapacity = 1024;
+
+    private:
+        struct InFlight
+        {
+            GLsync fence;
+            Clock::time_point input;
+        };
+
+        Axis _x;
+        Axis _y;
+        Axis _homeX;
+        Axis _homeY;
+        float _zoomStep = 1.15f;
+        bool _changed = true;
+        bool _dragging = false;
+        float _cursorX = 0.0f;
+        float _cursorY = 0.0f;
+
+        FrameProfiler *_profiler = nullptr;
+        size_t _latencyChannel = 0;
+        // first input not drawn yet, and input of the changes drawn in the current frame
+        std::optional<Clock::time_point> _pendingInput;
+        std::optional<Clock::time_point> _drawnInput;
+        std::deque<InFlight> _inFlight;
+        std::deque<float> _latencies;
+
+        void changed()
+        {
+            _changed = true;
+            if (!_pendingInput)
+            {
+                _pendingInput = Clock::now();
+            }
+        }
+
+        // Window coordinates to clip space of the whole window
+        void setCursor(glfw::Window &window, double x, double y)
+        {
+            const auto [width, height] = window.getSize();
+            _cursorX = width > 0 ? static_cast<float>(2.0 * x / width - 1.0) : 0.0f;
+            _cursorY = height > 0 ? static_cast<float>(1.0 - 2.0 * y / height) : 0.0f;
+        }
+
+    public:
+        ViewController(const Axis &x, const Axis &y) :
+            _x(x), _y(y), _homeX(x), _homeY(y)
+        {
+        }
+
+        ViewController(const ViewController &) = delete;
+        ViewController &operator=(const ViewController &) = delete;
+
+        ~ViewController()
+        {
+            for (const auto &frame : _inFlight)
+            {
+                glDeleteSync(frame.fence);
+            }
+        }
+
+        // Takes over the scroll, cursor position and mouse button events of the window
+        void attach(glfw::Window &window)
+        {
+            window.scrollEvent.setCallback([this](glfw::Window &, double, double yOffset)
+                                           { zoom(std::pow(_zoomStep, static_cast<float>(-yOffset)), _cursorX, _cursorY); });
+            window.cursorPosEvent.setCallback([this](glfw::Window &wnd, double x, double y)
+                                              {
+                                                  const float lastX = _cursorX;
+                                                  const float lastY = _cursorY;
+                                                  setCursor(wnd, x, y);
+                                                  if (_dragging)
+                                                  {
+                                                      pan(_cursorX - lastX, _cursorY - lastY);
+                                                  } });
+            window.mouseButtonEvent.setCallback([this](glfw::Window &, glfw::MouseButton button, glfw::MouseButtonState state, glfw::ModifierKeyBit)
+                                                {
+                                                    if (button == glfw::MouseButton::Left)
+                                                    {
+                                                        _dragging = state == glfw::MouseButtonState::Press;
+                                                    }
+                                                    else if (button == glfw::MouseButton::Middle && state == glfw::MouseButtonState::Press)
+                                                    {
+                                                        reset();
+                                                    } });
+            const auto [x, y] = window.getCursorPos();
+            setCursor(window, x, y);
+        }
+
+        // Records latencies into a profiler channel "input latency", 0 in frames without a view change
+        void trackLatency(FrameProfiler &profiler)
+        {
+            _profiler = &profiler;
+            _latencyChannel = profiler.addChannel("input latency");
+        }
+
+        [[nodiscard]] const Axis &x() const
+        {
+            return _x;
+        }
+
+        [[nodiscard]] const Axis &y() const
+        {
+            return _y;
+        }
+
+        // For changes other than pan and zoom, e.g. switching the scale; call invalidate() afterwards
+        [[nodiscard]] Axis &x()
+        {
+            return _x;
+        }
+
+        [[nodiscard]] Axis &y()
+        {
+            return _y;
+        }
+
+        void invalidate()
+        {
+            changed();
+        }
+
+        // Scales both domains by factor around the clip space point (clipX, clipY), < 1 zooms in
+        void zoom(float factor, float clipX, float clipY)
+        {
+            _x.zoom(factor, clipX);
+            _y.zoom(factor, clipY);
+            changed();
+        }
+
+        // Moves the view with the cursor by a clip space distance
+        void pan(float clipDeltaX, float clipDeltaY)
+        {
+            _x.pan(clipDeltaX);
+            _y.pan(clipDeltaY);
+            changed();
+        }
+
+        void reset()
+        {
+            _x = _homeX;
+            _y = _homeY;
+            changed();
+        }
+
+        // Call once per frame before drawing; true when the axes changed and setAxes() has to be called
+        bool update()
+        {
+            if (!_changed)
+            {
+                return false;
+            }
+            _changed = false;
+            _drawnInput = _pendingInput;
+            _pendingInput.reset();
+            return true;
+        }
+
+        // Call after Canvas::present(). Fences the frame if it showed a view change and records the latency
+        // of earlier frames the GPU has finished since.
+        void presented()
+        {
+            if (!_profiler)
+            {
+                return;
+            }
+            if (_drawnInput)
+            {
+                _inFlight.push_back({glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), *_drawnInput});
+                _drawnInput.reset();
+            }
+
+            while (!_inFlight.empty())
+            {
+                const GLenum status = glClientWaitSync(_inFlight.front().fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+                if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+                {
+                    break;
+                }
+                const double ms = std::chrono::duration<double, std::milli>(Clock::now() - _inFlight.front().input).count();
+                glDeleteSync(_inFlight.front().fence);
+                _inFlight.pop_front();
+
+                _profiler->record(_latencyChannel, ms);
+                CPPPLOT_TRACE_COUNTER("input latency ms", ms);
+                _latencies.push_back(static_cast<float>(ms));
+                if (_latencies.size() > latencyCapacity)
+                {
+                    _latencies.pop_front();
+                }
+            }
+        }
+
+        // Over the last latencyCapacity view changes, unlike the profiler channel which also counts idle frames
+        [[nodiscard]] StageStats latencyStats() const
+        {
+            return summarize(std::vector<float>(_latencies.begin(), _latencies.end()));
+        }
+    };
+}
+
+#endif
@@ -1,2 +1,2 @@
-g++ ./src/line.cpp -o ./build/line.exe -I./include/ -L./lib -lglfw3 -lopengl32 -lgdi32 -lglew32 -lglu32 --std=c++17 -Wall -Wextra -pedantic -O3 -ffast-math
+g++ ./src/line.cpp -o ./build/line.exe -I./include/ -L./lib -lglfw3 -lopengl32 -lgdi32 -lglew32 -lglu32 -DCPPPLOT_HAS_ZLIB -lz --std=c++17 -Wall -Wextra -pedantic -O3 -ffast-math -pthread
 .\build\line.exe
\ No newline at end of file
@@ -1,20 +1,43 @@
 #include <GL/glew.h>
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cppplot/axis_transform.h>
+#include <cppplot/canvas.h>
+#include <cppplot/capture.h>
+#include <cppplot/csv_reader.h>
+#include <cppplot/decimate.h>
+#include <cppplot/frame_stream.h>
+#include <cppplot/gpu_timer.h>
+#include <cppplot/id_picking.h>
+#include <cppplot/image_export.h>
+#include <cppplot/profiler.h>
+#include <cppplot/soft_raster.h>
+#include <cppplot/synth.h>
+#include <cppplot/thick_lines.h>
+#include <cppplot/upload.h>
 #include <glfwpp/glfwpp.h>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
-#include <chrono>
 
 const int lineNum = 3300;
 const int lineSize = 2000;
 
+// update every Nth line per frame, e.g. 20 updates ~5% of the channels
+const int lineUpdateStride = 1;
+// dirty ranges closer than this are sent in a single upload call
+const size_t uploadMergeGap = 4096;
+
 std::vector<float> vertices(lineNum *lineSize * 2);
 std::vector<char> colors(lineNum *lineSize * 3);
+std::vector<cppplot::DirtyIntervals> dirtyLines(lineNum);
 
-std::chrono::high_resolution_clock timer;
-std::chrono::nanoseconds elapsed(0);
-int fps = 0;
+cppplot::FrameProfiler profiler;
 
 void initVertices(std::vector<float> &vertices)
 {
@@ -22,8 +45,7 @@ void initVertices(std::vector<float> &vertices)
     {
         for (int j = 0; j < lineSize; j++)
         {
-            const float x = 2 * (float)j / (float)lineSize - 1.0f;
-            vertices[(i * lineSize + j) * 2] = x;
+            vertices[(i * lineSize + j) * 2] = (float)j;
             vertices[(i * lineSize + j) * 2 + 1] = 0.0;
         }
     }
@@ -31,31 +53,35 @@ void initVertices(std::vector<float> &vertices)
 
 void initColors(std::vector<char> &colors)
 {
+    // one colour per line, the same on every run
+    std::vector<uint8_t> rgb(lineNum * 3);
+    cppplot::Synth(1).bytes(rgb.data(), rgb.size());
     for (int i = 0; i < lineNum; i++)
     {
-        const float r = std::rand() / (float)RAND_MAX;
-        const float g = std::rand() / (float)RAND_MAX;
-        const float b = std::rand() / (float)RAND_MAX;
+        const char r = rgb[i * 3];
+        const char g = rgb[i * 3 + 1];
+        const char b = rgb[i * 3 + 2];
 
         for (int j = 0; j < lineSize; j++)
         {
-            colors[(i * lineSize + j) * 3] = r * 255.0f;
-            colors[(i * lineSize + j) * 3 + 1] = g * 255.0f;
-            colors[(i * lineSize + j) * 3 + 2] = b * 255.0f;
+            colors[(i * lineSize + j) * 3] = r;
+            colors[(i * lineSize + j) * 3 + 1] = g;
+            colors[(i * lineSize + j) * 3 + 2] = b;
         }
     }
 }
 
-void updateVertices(std::vector<float> &vertices, float phase = 0.0f)
+void updateVertices(std::vector<float> &vertices, float phase = 0.0f, int frame = 0)
 {
-    for (int i = 0; i < lineNum; i++)
+    for (int i = frame % lineUpdateStride; i < lineNum; i += lineUpdateStride)
     {
+        dirtyLines[i].markAll(lineSize);
         const float y0 = (float)i / (float)lineNum + phase * 0.1f;
         for (int j = 0; j < lineSize; j++)
         {
             const float y = y0 + j * 0.1 / (float)lineSize;
             const float yy = y - std::lroundf(y);
-            vertices[(i * lineSize + j) * 2 + 1] = 2 * yy;
+            vertices[(i * lineSize + j) * 2 + 1] = yy;
         }
     }
 }
@@ -76,123 +102,268 @@ void printColors(const std::vector<float> &colors)
     }
 }
 
-void onResize([[maybe_unused]] GLFWwindow *window, int width, int height)
+// x is the sample index and y the wrapped offset in [-0.5, 0.5], mapped to the window by the shader
+void initAxes(cppplot::Axis &xAxis, cppplot::Axis &yAxis)
 {
-    glViewport(0, 0, width, height);
+    xAxis.domainMin = 0.0f;
+    xAxis.domainMax = lineSize;
+    yAxis.domainMin = -0.5f;
+    yAxis.domainMax = 0.5f;
 }
 
-int main()
+// Draws the same lines with the CPU rasteriser, for machines without any GL driver, and writes the last
+// frame to line.ppm
+int renderSoftware(int frames)
 {
+    initVertices(vertices);
+    initColors(colors);
 
-    std::cout << "Hello, GLFWPP!" << std::endl;
+    cppplot::Scene scene;
+    scene.width = 1200;
+    scene.height = 800;
+    initAxes(scene.x, scene.y);
+    cppplot::Series lines;
+    lines.xy = vertices.data();
+    lines.count = vertices.size() / 2;
+    lines.stripLength = lineSize;
+    lines.rgb = reinterpret_cast<const uint8_t *>(colors.data());
+    scene.series.push_back(lines);
+
+    cppplot::SoftRasterizer rasterizer;
+    std::cout << "Software rendering with " << cppplot::hardwareThreads() << " threads" << std::endl;
+    for (int frame = 0; frame < frames; frame++)
+    {
+        profiler.beginFrame();
+        {
+            const auto stage = profiler.scope(cppplot::Stage::DataUpdate);
+            updateVertices(vertices, frame / 60.0f, frame);
+        }
+        {
+            const auto stage = profiler.scope(cppplot::Stage::Draw);
+            rasterizer.render(scene);
+        }
+        profiler.endFrame();
+    }
+    profiler.reportDue(std::chrono::nanoseconds(0));
+    profiler.print(std::cout);
+    return cppplot::writePpm("line.ppm", scene.width, scene.height, rasterizer.render(scene)) ? 0 : 1;
+}
 
-    glfw::GlfwLibrary library = glfw::init();
-
-    glfw::WindowHints hints;
-    hints.clientApi = glfw::ClientApi::OpenGl;
-    hints.contextVersionMajor = 4;
-    hints.contextVersionMinor = 6;
-    hints.apply();
-    // Or with C++20:
-    // glfw::WindowHints{
-    //        .clientApi = glfw::ClientApi::OpenGl,
-    //        .contextVersionMajor = 4,
-    //        .contextVersionMinor = 6}
-    //        .apply();
-    glfw::Window wnd(1200, 800, "Line Example");
+// Plots every column of a numeric CSV log against the row number while the file loads. Each block the
+// reader hands over is decimated per column to the window width, appended to the vertex buffer as one
+// strip per column joined to the previous block, and drawn right away with the axes grown to the data
+// so far, so the start of a large file shows long before the rest is parsed. Writes line.ppm offscreen.
+template <typename Shader>
+int plotCsv(cppplot::Canvas &canvas, const std::string &path, const Shader &shader)
+{
+    GLuint buffers[2];
+    glGenBuffers(2, buffers);
+    shader.setupAttributes(buffers[0], buffers[1]);
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 
-    glEnable(GL_DEBUG_OUTPUT);
+    const auto [width, height] = canvas.getSize();
+    const size_t columns = static_cast<size_t>(std::max(width, 1));
+    std::vector<float> xy;
+    std::vector<uint8_t> rgb;
+    std::vector<std::pair<GLint, GLsizei>> strips;
+    std::vector<uint8_t> palette;
+    // the last vertex of each column, the next strip starts there
+    std::vector<float> last;
+    std::vector<float> blockXy;
+    std::vector<float> decimated(columns * 4);
+    size_t capacity = 0;
+
+    cppplot::Axis xAxis;
+    cppplot::Axis yAxis;
+    float yMin = std::numeric_limits<float>::infinity();
+    float yMax = -yMin;
+
+    const auto draw = [&]()
+    {
+        glClear(GL_COLOR_BUFFER_BIT);
+        shader.use();
+        shader.setAxes(xAxis, yAxis);
+        for (const auto &[first, count] : strips)
+        {
+            glDrawArrays(GL_LINE_STRIP, first, count);
+        }
+        canvas.pollEvents();
+        canvas.present();
+    };
+
+    cppplot::CsvReader reader;
+    const auto start = std::chrono::steady_clock::now();
+    double firstFrameMs = -1;
+    size_t rows = 0;
+    try
+    {
+        rows = reader.read(path, [&](const cppplot::CsvBlock &block)
+                           {
+                               const size_t count = block.columns.size();
+                               if (palette.empty())
+                               {
+                                   palette.resize(count * 3);
+                                   cppplot::Synth(1).bytes(palette.data(), palette.size(), 80, 255);
+                                   last.assign(count * 2, std::numeric_limits<float>::quiet_NaN());
+                               }
+
+                               const size_t before = xy.size();
+                               blockXy.resize(block.rows * 2);
+                               for (size_t c = 0; c < count; c++)
+                               {
+                                   block.toXy(blockXy.data(), c);
+                                   const size_t vertices = cppplot::decimateMinMax(blockXy.data(), block.rows, columns, decimated.data());
+                                   const auto first = static_cast<GLint>(xy.size() / 2);
+                                   if (!std::isnan(last[c * 2]))
+                                   {
+                                       xy.insert(xy.end(), last.begin() + c * 2, last.begin() + c * 2 + 2);
+                                   }
+                                   xy.insert(xy.end(), decimated.begin(), decimated.begin() + vertices * 2);
+                                   std::copy(decimated.begin() + (vertices - 1) * 2, decimated.begin() + vertices * 2, last.begin() + c * 2);
+                                   strips.emplace_back(first, static_cast<GLsizei>(xy.size() / 2 - first));
+                                   for (GLsizei v = 0; v < strips.back().second; v++)
+                                   {
+                                       rgb.insert(rgb.end(), palette.begin() + c * 3, palette.begin() + c * 3 + 3);
+                                   }
+                                   for (size_t v = 0; v < vertices * 2; v += 2)
+                                   {
+                                       // missing fields are NaN, they neither widen the axis nor draw
+                                       if (!std::isnan(decimated[v + 1]))
+                                       {
+                                           yMin = std::min(yMin, decimated[v + 1]);
+                                           yMax = std::max(yMax, decimated[v + 1]);
+                                       }
+                                   }
+                               }
+                               // the buffers double when full, otherwise only the new strips are sent
+                               glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+                               if (xy.size() > capacity)
+                               {
+                                   capacity = std::max(xy.size(), capacity * 2);
+                                   glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+                                   glBufferSubData(GL_ARRAY_BUFFER, 0, xy.size() * sizeof(float), xy.data());
+                                   glBindBuffer(GL_ARRAY_BUFFER, buffers[1]);
+                                   glBufferData(GL_ARRAY_BUFFER, capacity / 2 * 3, nullptr, GL_DYNAMIC_DRAW);
+                                   glBufferSubData(GL_ARRAY_BUFFER, 0, rgb.size(), rgb.data());
+                               }
+                               else
+                               {
+                                   glBufferSubData(GL_ARRAY_BUFFER, before * sizeof(float), (xy.size() - before) * sizeof(float), xy.data() + before);
+                                   glBindBuffer(GL_ARRAY_BUFFER, buffers[1]);
+                                   glBufferSubData(GL_ARRAY_BUFFER, before / 2 * 3, rgb.size() - before / 2 * 3, rgb.data() + before / 2 * 3);
+                               }
+
+                               xAxis.domainMin = 0.0f;
+                               xAxis.domainMax = static_cast<float>(std::max<size_t>(block.firstRow + block.rows - 1, 1));
+                               if (yMin <= yMax)
+                               {
+                                   const float margin = yMin < yMax ? (yMax - yMin) * 0.05f : 1.0f;
+                                   yAxis.domainMin = yMin - margin;
+                                   yAxis.domainMax = yMax + margin;
+                               }
+                               if (!canvas.shouldClose())
+                               {
+                                   draw();
+                               }
+                               if (firstFrameMs < 0)
+                               {
+                                   firstFrameMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                               }
+                           });
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cerr << e.what() << std::endl;
+        glDeleteBuffers(2, buffers);
+        return 1;
+    }
+    std::cout << path << ": " << rows << " rows, " << reader.columnCount() << " columns, first frame after "
+              << firstFrameMs << " ms, loaded after "
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << " ms"
+              << std::endl;
 
-    GLenum error = glGetError();
+    // at least one frame with the whole file
+    do
+    {
+        draw();
+    } while (!canvas.shouldClose());
 
-    if (wnd == nullptr)
+    if (canvas.backend() == cppplot::Backend::Offscreen)
     {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        // glfw::terminate();
-        return -1;
+        cppplot::writePpm("line.ppm", width, height, canvas.readPixels());
     }
+    glDeleteBuffers(2, buffers);
+    return 0;
+}
 
-    glfw::makeContextCurrent(wnd);
+void onResize([[maybe_unused]] GLFWwindow *window, int width, int height)
+{
+    glViewport(0, 0, width, height);
+}
 
-    glfw::swapInterval(1);
+int main(int argc, char **argv)
+{
 
-    std::cout << "GLFW version: " << glfw::getVersionString() << std::endl;
+    std::cout << "Hello, GLFWPP!" << std::endl;
 
-    std::cout << "GLFW version: " << glGetString(GL_VERSION) << std::endl;
-    if (glewInit() != GLEW_OK)
+    // --software [frames] renders on the CPU without creating any GL context
+    for (int i = 1; i < argc; i++)
     {
-        throw std::runtime_error("Could not initialize GLEW");
+        if (std::string(argv[i]) == "--software")
+        {
+            return renderSoftware(i + 1 < argc && std::atoi(argv[i + 1]) > 0 ? std::atoi(argv[i + 1]) : 1);
+        }
     }
 
-    const std::string vertexShaderSource = R"(
-        #version 330 core
-        layout (location = 1) in vec2 aPos;
-        layout (location = 2) in vec3 aColor;
+    // --headless [frames] renders offscreen, without a display
+    int frameLimit = 0;
+    const auto backend = cppplot::backendFromArgs(argc, argv, frameLimit);
+    cppplot::Canvas canvas(1200, 800, "Line Example", backend, frameLimit);
 
-        out vec3 vColor;
-        
-        void main()
+    // --stream <path> [budget KB] sends changed tiles of each offscreen frame to path, e.g. a pipe read
+    // by the notebook kernel
+    const char *streamPath = nullptr;
+    size_t streamBudget = 256 * 1024;
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (std::string(argv[i]) == "--stream")
         {
-            vColor = aColor;
-            gl_Position = vec4(aPos.x, aPos.y, 0, 1.0);
-            vColor = aColor/ vec3(255.0, 255.0, 255.0);
+            streamPath = argv[i + 1];
+            streamBudget = i + 2 < argc ? std::atoi(argv[i + 2]) * size_t(1024) : streamBudget;
         }
-    )";
+    }
 
-    const std::string fragmentShaderSource = R"(
-        #version 330 core
-        in vec3 vColor;
-        out vec4 FragColor;
-        void main()
+    // --thick [width] draws anti-aliased lines width pixels wide (default 2) instead of GL_LINE_STRIP
+    float lineWidth = 0.0f;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::string(argv[i]) == "--thick")
         {
-            FragColor = vec4(vColor, 0.7);
+            lineWidth = i + 1 < argc && std::atof(argv[i + 1]) > 0 ? std::atof(argv[i + 1]) : 2.0f;
         }
-    )";
-
-    const auto vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    const GLchar *vertexShaderSourcePtr = vertexShaderSource.c_str();
-    glShaderSource(vertexShader, 1, &vertexShaderSourcePtr, nullptr);
-    glCompileShader(vertexShader);
-
-    GLint success;
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        GLchar infoLog[512];
-        glGetShaderInfoLog(vertexShader, sizeof(infoLog), nullptr, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-                  << infoLog << std::endl;
     }
 
-    const auto fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    const GLchar *fragmentShaderSourcePtr = fragmentShaderSource.c_str();
-    glShaderSource(fragmentShader, 1, &fragmentShaderSourcePtr, nullptr);
-    glCompileShader(fragmentShader);
+    glEnable(GL_DEBUG_OUTPUT);
 
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
+    GLenum error = glGetError();
+
+    if (canvas.window())
     {
-        GLchar infoLog[512];
-        glGetShaderInfoLog(fragmentShader, sizeof(infoLog), nullptr, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-                  << infoLog << std::endl;
+        std::cout << "GLFW version: " << glfw::getVersionString() << std::endl;
     }
 
-    const auto shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
+    std::cout << "GL version: " << glGetString(GL_VERSION) << std::endl;
 
-    // Check for link errors
-    int success2;
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success2);
-    if (!success2)
-    {
-        char infoLog[512];
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::PROGRAM::LINKING_FAILED\n"
-                  << infoLog << std::endl;
-    }
+    // programs are shared between plots and loaded from shader_cache/ after the first run
+    cppplot::ShaderManager shaders;
+    const auto shaderStart = std::chrono::steady_clock::now();
+    const cppplot::ShaderVariant<cppplot::AxisTransforms, cppplot::SeriesColor> lineShader(shaders);
+    const cppplot::ShaderVariant<cppplot::AxisTransforms, cppplot::PickId> pickShader(shaders);
+    const cppplot::ShaderVariant<cppplot::AxisTransforms, cppplot::ThickLines, cppplot::SeriesColor> thickShader(shaders);
+    const cppplot::ShaderVariant<cppplot::AxisTransforms, cppplot::ThickLines, cppplot::PickId> thickPickShader(shaders);
+    std::cout << "Shader setup: "
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - shaderStart).count()
+              << " ms (" << (shaders.loaded() ? "binary cache" : "compiled") << ")" << std::endl;
 
     [[maybe_unused]] const auto VAO = []()
     {
@@ -202,6 +373,15 @@ int main()
         return VAO;
     }();
 
+    // --csv <path> plots the columns of a CSV log while it loads, instead of the synthetic lines
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (std::string(argv[i]) == "--csv")
+        {
+            return plotCsv(canvas, argv[i + 1], lineShader);
+        }
+    }
+
     const auto VBO = []()
     {
         GLuint VBO;
@@ -226,20 +406,44 @@ int main()
 
     glBindBuffer(GL_ARRAY_BUFFER, CBO);
     glBufferData(GL_ARRAY_BUFFER, colors.size() * sizeof(char), colors.data(), GL_STATIC_DRAW);
-    auto colorAttribute = glGetAttribLocation(shaderProgram, "aColor");
-    glEnableVertexAttribArray(colorAttribute);
-    glVertexAttribPointer(colorAttribute, 3, GL_UNSIGNED_BYTE, GL_FALSE, 0, (void *)0);
 
     // Position
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-    auto positionAttribute = glGetAttribLocation(shaderProgram, "aPos");
-    glEnableVertexAttribArray(positionAttribute);
-    glVertexAttribPointer(positionAttribute, 2, GL_FLOAT, GL_FALSE, 0, (void *)0);
+    if (lineWidth > 0.0f)
+    {
+        thickShader.setupAttributes(VBO, CBO);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+    else
+    {
+        lineShader.setupAttributes(VBO, CBO);
+    }
 
     // setup
 
-    glUseProgram(shaderProgram);
+    const auto useLineShader = [&]()
+    {
+        lineWidth > 0.0f ? thickShader.use() : lineShader.use();
+    };
+    const auto usePickShader = [&]()
+    {
+        lineWidth > 0.0f ? thickPickShader.use() : pickShader.use();
+    };
+
+    cppplot::Axis xAxis;
+    cppplot::Axis yAxis;
+    initAxes(xAxis, yAxis);
+    lineShader.use();
+    lineShader.setAxes(xAxis, yAxis);
+    pickShader.use();
+    pickShader.setAxes(xAxis, yAxis);
+    thickShader.use();
+    thickShader.setAxes(xAxis, yAxis);
+    thickPickShader.use();
+    thickPickShader.setAxes(xAxis, yAxis);
+    useLineShader();
 
     const auto bufferSize = vertices.size() * sizeof(float);
     std::cout << "Buffer size: " << bufferSize << std::endl;
@@ -254,43 +458,173 @@ int main()
         error = glGetError();
     }
 
-    glfwSetWindowSizeCallback(wnd, onResize);
+    cppplot::GpuTimer gpuTimer(profiler);
+    const auto drawPass = gpuTimer.addPass("line", "lines");
+    const auto pickPass = gpuTimer.addPass("line", "pick");
 
-    initVertices(vertices);
+    // frames recorded as line_<frame>.png while capturing
+    cppplot::ImageExporter exporter;
+    std::unique_ptr<cppplot::FrameCapture> capture;
 
-    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+    std::FILE *streamFile = nullptr;
+    std::unique_ptr<cppplot::FrameStreamer> streamer;
+    if (streamPath && canvas.backend() == cppplot::Backend::Offscreen)
+    {
+        streamFile = std::fopen(streamPath, "wb");
+        if (streamFile)
+        {
+            const auto [width, height] = canvas.getSize();
+            streamer = std::make_unique<cppplot::FrameStreamer>(width, height, 64, streamBudget);
+            capture = std::make_unique<cppplot::FrameCapture>(width, height, [&](const cppplot::CapturedFrame &frame)
+                                                              { cppplot::writeMessage(streamFile, streamer->encode(frame.rgba.data())); });
+        }
+    }
+
+    // the line and sample under the cursor are shown in the title bar
+    std::unique_ptr<cppplot::IdPicker> picker;
 
-    while (!wnd.shouldClose())
+    if (auto *wnd = canvas.window())
     {
-        auto start = timer.now();
+        glfwSetWindowSizeCallback(*wnd, onResize);
+        const auto [width, height] = wnd->getFramebufferSize();
+        picker = std::make_unique<cppplot::IdPicker>(width, height);
+
+        // press P to dump the recorded frame timings, T to start/stop a Chrome trace, C to start/stop capture
+        wnd->keyEvent.setCallback([&](glfw::Window &window, glfw::KeyCode key, int, glfw::KeyState state, glfw::ModifierKeyBit)
+                                 {
+                                     if (key == glfw::KeyCode::C && state == glfw::KeyState::Press)
+                                     {
+                                         if (capture)
+                                         {
+                                             capture.reset();
+                                         }
+                                         else
+                                         {
+                                             const auto [width, height] = window.getFramebufferSize();
+                                             capture = std::make_unique<cppplot::FrameCapture>(width, height, [&exporter](const cppplot::CapturedFrame &frame)
+                                                                                              { exporter.submit(frame.rgba, frame.width, frame.height, "line_" + std::to_string(frame.index) + ".png"); });
+                                         }
+                                     }
+                                     if (key == glfw::KeyCode::P && state == glfw::KeyState::Press)
+                                     {
+                                         profiler.dumpCsv("line_profile.csv");
+                                     }
+                                     if (key == glfw::KeyCode::T && state == glfw::KeyState::Press)
+                                     {
+                                         auto &trace = cppplot::TraceWriter::instance();
+                                         if (trace.enabled())
+                                         {
+                                             trace.stop();
+                                         }
+                                         else
+                                         {
+                                             trace.start("line_trace.json");
+                                         }
+                                     }
+                                 });
+    }
 
-        double time = glfw::getTime();
-        glClear(GL_COLOR_BUFFER_BIT);
-        // glClearColor((sin(time) + 1.0) / 2.0, (cos(time) + 1.0) / 2.0, (-sin(time) + 1.0) / 2.0, 0.0);
+    initVertices(vertices);
 
-        updateVertices(vertices, time);
+    glBufferData(GL_ARRAY_BUFFER, bufferSize, vertices.data(), GL_DYNAMIC_DRAW);
 
-        glBufferData(GL_ARRAY_BUFFER, bufferSize, vertices.data(), GL_DYNAMIC_DRAW);
+    int frame = 0;
 
+    // all lines in one instanced draw when thick, with the thick variant matching the program in use
+    const auto drawLines = [&](const auto &thick)
+    {
+        if (lineWidth > 0.0f)
+        {
+            const auto [width, height] = canvas.getSize();
+            thick.setLineWidth(lineWidth, width, height);
+            thick.draw(0, lineNum * lineSize, lineSize);
+            return;
+        }
         for (int i = 0; i < lineNum; i++)
         {
             glDrawArrays(GL_LINE_STRIP, i * lineSize, lineSize);
         }
+    };
 
-        glfw::pollEvents();
-        wnd.swapBuffers();
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 
-        auto end = timer.now();
+    while (!canvas.shouldClose())
+    {
+        profiler.beginFrame();
+        gpuTimer.beginFrame();
 
-        elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+        double time = canvas.time();
+        glClear(GL_COLOR_BUFFER_BIT);
+        // glClearColor((sin(time) + 1.0) / 2.0, (cos(time) + 1.0) / 2.0, (-sin(time) + 1.0) / 2.0, 0.0);
 
-        fps++;
+        {
+            const auto stage = profiler.scope(cppplot::Stage::DataUpdate);
+            updateVertices(vertices, time, frame++);
+            // the lines move under a still cursor, picked again at the picker's refresh rate
+            if (picker)
+            {
+                picker->dataChanged();
+            }
+        }
+        {
+            const auto stage = profiler.scope(cppplot::Stage::Upload);
+            const auto bytes = cppplot::uploadDirty(GL_ARRAY_BUFFER, dirtyLines, lineSize, 2 * sizeof(float), vertices.data(), uploadMergeGap);
+            CPPPLOT_TRACE_COUNTER("bytes uploaded", bytes);
+        }
+        {
+            const auto stage = profiler.scope(cppplot::Stage::Draw);
+            const auto gpu = gpuTimer.scope(drawPass);
+            drawLines(thickShader);
+            CPPPLOT_TRACE_COUNTER("vertices drawn", lineNum * lineSize);
+        }
+        if (picker && picker->begin(*canvas.window()))
+        {
+            const auto stage = profiler.scope(cppplot::Stage::Draw);
+            const auto gpu = gpuTimer.scope(pickPass);
+            usePickShader();
+            drawLines(thickPickShader);
+            picker->end();
+            useLineShader();
+        }
+        if (picker && picker->poll())
+        {
+            const auto &hit = picker->result();
+            const std::string title = hit ? "Line Example - line " + std::to_string(hit->index / lineSize) + ", sample " +
+                                                std::to_string(hit->index % lineSize)
+                                          : "Line Example";
+            canvas.window()->setTitle(title.c_str());
+        }
+
+        if (capture)
+        {
+            capture->capture(canvas.framebuffer() ? canvas.framebuffer()->id() : 0);
+        }
 
-        if (elapsed.count() > 1e9)
         {
-            std::cout << "FPS: " << fps << std::endl;
-            elapsed = std::chrono::nanoseconds(0);
-            fps = 0;
+            const auto stage = profiler.scope(cppplot::Stage::PollEvents);
+            canvas.pollEvents();
+        }
+        {
+            const auto stage = profiler.scope(cppplot::Stage::Swap);
+            canvas.present();
+        }
+
+        profiler.endFrame();
+
+        if (profiler.reportDue())
+        {
+            profiler.print(std::cout);
         }
     }
-}
\ No newline at end of file
+
+    if (canvas.backend() == cppplot::Backend::Offscreen)
+    {
+        const auto [width, height] = canvas.getSize();
+        cppplot::writePpm("line.ppm", width, height, canvas.readPixels());
+    }
+    if (streamFile)
+    {
+        capture.reset();
+        std::fclose(streamFile);
+    }
+}
@@ -0,0 +1,232 @@
+#include <GL/glew.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cppplot/canvas.h>
+#include <cppplot/profiler.h>
+#include <cppplot/resource_pool.h>
+#include <cppplot/shader_variants.h>
+#include <cppplot/synth.h>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Wall display: several line plot windows drawing the same static data. By default the windows form one
+// share group and the program, vertex and colour buffers are created once in a ResourcePool, each
+// window only owning its VAO; --no-share gives every window its own context and copies for comparison.
+// Startup time and video memory are reported for all windows and for the first one alone.
+//
+//   multi [--windows N] [--no-share] [--headless [frames]]
+
+const int lineNum = 100;
+const int lineSize = 4000;
+
+using LineShader = cppplot::ShaderVariant<cppplot::TimeShift, cppplot::SeriesColor>;
+
+struct Plot
+{
+    std::unique_ptr<cppplot::Canvas> canvas;
+    std::unique_ptr<cppplot::ResourcePool> ownPool;
+    std::unique_ptr<cppplot::VertexArray> vao;
+    std::unique_ptr<LineShader> shader;
+    float speed;
+};
+
+cppplot::FrameProfiler profiler;
+
+// Lines span two plot widths so they can scroll by one width and wrap
+void initVertices(std::vector<float> &vertices)
+{
+    for (int i = 0; i < lineNum; i++)
+    {
+        for (int j = 0; j < lineSize; j++)
+        {
+            const float x = -1.0f + 4.0f * j / (lineSize - 1);
+            vertices[(i * lineSize + j) * 2] = x;
+            vertices[(i * lineSize + j) * 2 + 1] = 0.9f * (2.0f * i / lineNum - 1.0f) + 0.02f * std::sin(x * 3.14159f * 4.0f + i);
+        }
+    }
+}
+
+void initColors(std::vector<uint8_t> &colors)
+{
+    // one colour per line, the same on every run
+    std::vector<uint8_t> rgb(lineNum * 3);
+    cppplot::Synth(1).bytes(rgb.data(), rgb.size());
+    for (int i = 0; i < lineNum; i++)
+    {
+        const uint8_t r = rgb[i * 3];
+        const uint8_t g = rgb[i * 3 + 1];
+        const uint8_t b = rgb[i * 3 + 2];
+        for (int j = 0; j < lineSize; j++)
+        {
+            colors[(i * lineSize + j) * 3] = r;
+            colors[(i * lineSize + j) * 3 + 1] = g;
+            colors[(i * lineSize + j) * 3 + 2] = b;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int windows = 8;
+    bool share = true;
+    int frameLimit;
+    const auto backend = cppplot::backendFromArgs(argc, argv, frameLimit);
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--windows" && i + 1 < argc)
+        {
+            windows = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--no-share")
+        {
+            share = false;
+        }
+    }
+
+    std::vector<float> vertices(static_cast<size_t>(lineNum) * lineSize * 2);
+    std::vector<uint8_t> colors(static_cast<size_t>(lineNum) * lineSize * 3);
+    initVertices(vertices);
+    initColors(colors);
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<Plot> plots(windows);
+    std::unique_ptr<cppplot::ResourcePool> sharedPool;
+    long memoryBefore = -1;
+    long memoryFirst = -1;
+    double firstMs = 0;
+
+    for (int w = 0; w < windows; w++)
+    {
+        Plot &plot = plots[w];
+        const cppplot::Canvas *shareWith = share && w > 0 ? plots[0].canvas.get() : nullptr;
+        plot.canvas = std::make_unique<cppplot::Canvas>(400, 300, "Plot " + std::to_string(w + 1), backend, frameLimit, shareWith);
+        if (w == 0)
+        {
+            memoryBefore = cppplot::availableVideoMemoryKb();
+        }
+
+        cppplot::ResourcePool *pool = sharedPool.get();
+        if (!share)
+        {
+            plot.ownPool = std::make_unique<cppplot::ResourcePool>();
+            pool = plot.ownPool.get();
+        }
+        else if (!pool)
+        {
+            sharedPool = std::make_unique<cppplot::ResourcePool>();
+            pool = sharedPool.get();
+        }
+
+        plot.vao = std::make_unique<cppplot::VertexArray>();
+        plot.shader = std::make_unique<LineShader>(pool->shaders());
+        const auto VBO = pool->staticBuffer("line positions", vertices.data(), vertices.size() * sizeof(float));
+        const auto CBO = pool->staticBuffer("line colors", colors.data(), colors.size());
+        plot.shader->setupAttributes(VBO, CBO);
+        plot.speed = 0.002f * (w + 1);
+
+        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        plot.shader->use();
+        for (int i = 0; i < lineNum; i++)
+        {
+            glDrawArrays(GL_LINE_STRIP, i * lineSize, lineSize);
+        }
+        glFinish();
+        if (w == 0)
+        {
+            // one window alone, the baseline for the others
+            firstMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            memoryFirst = cppplot::availableVideoMemoryKb();
+        }
+    }
+
+    // the windows are presented one after the other, only the last swap of a frame waits for the blank
+    for (int w = 0; w < windows; w++)
+    {
+        plots[w].canvas->setVsync(w == windows - 1);
+    }
+
+    const double startupMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    size_t poolBytes = 0;
+    size_t programs = 0;
+    for (auto &plot : plots)
+    {
+        if (plot.ownPool)
+        {
+            poolBytes += plot.ownPool->bufferBytes() + plot.ownPool->textureBytes();
+            programs += plot.ownPool->shaders().compiled() + plot.ownPool->shaders().loaded();
+        }
+    }
+    if (sharedPool)
+    {
+        poolBytes = sharedPool->bufferBytes() + sharedPool->textureBytes();
+        programs = sharedPool->shaders().compiled() + sharedPool->shaders().loaded();
+    }
+
+    plots[0].canvas->makeCurrent();
+    const long memoryAfter = cppplot::availableVideoMemoryKb();
+    std::cout << windows << " windows, " << (share ? "shared" : "separate") << " contexts" << std::endl;
+    std::cout << "Startup: " << startupMs << " ms to first frame in every window, " << firstMs << " ms for the first"
+              << std::endl;
+    std::cout << "GL objects: " << programs << " programs, " << poolBytes / (1024 * 1024) << " MB of buffers and textures" << std::endl;
+    if (memoryBefore >= 0 && memoryAfter >= 0)
+    {
+        std::cout << "Video memory used: " << (memoryBefore - memoryAfter) / 1024 << " MB, "
+                  << (memoryBefore - memoryFirst) / 1024 << " MB by the first window" << std::endl;
+    }
+
+    bool running = true;
+    while (running)
+    {
+        profiler.beginFrame();
+        for (auto &plot : plots)
+        {
+            plot.canvas->makeCurrent();
+            {
+                const auto stage = profiler.scope(cppplot::Stage::Draw);
+                glClear(GL_COLOR_BUFFER_BIT);
+                plot.vao->bind();
+                plot.shader->use();
+                plot.shader->setShift(std::fmod(plot.speed * plot.canvas->frames(), 2.0f));
+                for (int i = 0; i < lineNum; i++)
+                {
+                    glDrawArrays(GL_LINE_STRIP, i * lineSize, lineSize);
+                }
+            }
+            {
+                const auto stage = profiler.scope(cppplot::Stage::Swap);
+                plot.canvas->present();
+            }
+            running = running && !plot.canvas->shouldClose();
+        }
+        {
+            const auto stage = profiler.scope(cppplot::Stage::PollEvents);
+            plots[0].canvas->pollEvents();
+        }
+        profiler.endFrame();
+
+        if (profiler.reportDue())
+        {
+            profiler.print(std::cout);
+        }
+    }
+
+    // GL objects go with a context of their group current, and shared canvases before the one they share
+    for (int w = windows - 1; w >= 0; w--)
+    {
+        plots[w].canvas->makeCurrent();
+        plots[w].shader.reset();
+        plots[w].vao.reset();
+        plots[w].ownPool.reset();
+        if (w == 0)
+        {
+            sharedPool.reset();
+        }
+        plots[w].canvas.reset();
+    }
+}
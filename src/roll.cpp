@@ -1,10 +1,21 @@
 #include <GL/glew.h>
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cppplot/canvas.h>
+#include <cppplot/gpu_timer.h>
+#include <cppplot/id_picking.h>
+#include <cppplot/mapped_file.h>
+#include <cppplot/profiler.h>
+#include <cppplot/shader_variants.h>
+#include <cppplot/synth.h>
+#include <cppplot/thick_lines.h>
+#include <exception>
 #include <glfwpp/glfwpp.h>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
-#include <chrono>
 
 const int lineNum = 3;
 const int rollBufferSize = 2000;
@@ -23,9 +34,7 @@ struct RollData
 std::vector<float> vertices(static_cast<size_t>(lineNum) * (rollBufferSize + 2) * 2);
 std::vector<char> colors(static_cast<size_t>(lineNum) * (rollBufferSize + 2) * 3);
 
-std::chrono::high_resolution_clock timer;
-std::chrono::nanoseconds elapsed(0);
-int fps = 0;
+cppplot::FrameProfiler profiler;
 
 void initVertices(std::vector<float> &vertices)
 {
@@ -42,29 +51,30 @@ void initVertices(std::vector<float> &vertices)
 
 void initColors(std::vector<char> &colors)
 {
+    // one colour per line, the same on every run
+    std::vector<uint8_t> rgb(lineNum * 3);
+    cppplot::Synth(1).bytes(rgb.data(), rgb.size());
     for (size_t i = 0; i < lineNum; i++)
     {
-        const float r = std::rand() / (float)RAND_MAX;
-        const float g = std::rand() / (float)RAND_MAX;
-        const float b = std::rand() / (float)RAND_MAX;
+        const char r = rgb[i * 3];
+        const char g = rgb[i * 3 + 1];
+        const char b = rgb[i * 3 + 2];
 
         for (size_t j = 0; j < lineSize; j++)
         {
-            colors[(i * lineSize + j) * 3] = r * 255.0f;
-            colors[(i * lineSize + j) * 3 + 1] = g * 255.0f;
-            colors[(i * lineSize + j) * 3 + 2] = b * 255.0f;
+            colors[(i * lineSize + j) * 3] = r;
+            colors[(i * lineSize + j) * 3 + 1] = g;
+            colors[(i * lineSize + j) * 3 + 2] = b;
         }
     }
 }
 
-void updateVertices(std::vector<float> &ys, RollData &rollData, GLint shiftUniform)
+void updateVertices(std::vector<float> &ys, RollData &rollData)
 {
     const int bfSize = rollBufferSize + 2;
     rollData.shift = rollData.shift + 2.0 / rollBufferSize;
     rollData.dataX = rollData.dataX + 2.0 / rollBufferSize;
 
-    glUniform1f(shiftUniform, rollData.shift);
-
     for (size_t i = 0; i < lineNum; i++)
     {
         std::vector<float> data = {rollData.dataX, ys[i]};
@@ -113,120 +123,75 @@ void onResize([[maybe_unused]] GLFWwindow *window, int width, int height)
     glViewport(0, 0, width, height);
 }
 
-int main()
+int main(int argc, char **argv)
 {
 
     std::cout << "Hello, GLFWPP!" << std::endl;
 
-    glfw::GlfwLibrary library = glfw::init();
-
-    glfw::WindowHints hints;
-    hints.clientApi = glfw::ClientApi::OpenGl;
-    hints.contextVersionMajor = 4;
-    hints.contextVersionMinor = 6;
-    hints.apply();
-    // Or with C++20:
-    // glfw::WindowHints{
-    //        .clientApi = glfw::ClientApi::OpenGl,
-    //        .contextVersionMajor = 4,
-    //        .contextVersionMinor = 6}
-    //        .apply();
-    glfw::Window wnd(1200, 800, "Line Example");
-
-    glEnable(GL_DEBUG_OUTPUT);
-
-    GLenum error = glGetError();
-
-    if (wnd == nullptr)
+    // --headless [frames] renders offscreen, without a display
+    int frameLimit = 0;
+    const auto backend = cppplot::backendFromArgs(argc, argv, frameLimit);
+    cppplot::Canvas canvas(1200, 800, "Line Example", backend, frameLimit);
+
+    // --thick [width] draws anti-aliased lines width pixels wide (default 2) instead of GL_LINE_STRIP
+    float lineWidth = 0.0f;
+    // --file path channels replays the first channels of a raw interleaved int16 recording, one frame per
+    // frame, instead of the synthetic data
+    std::unique_ptr<cppplot::SampleFile<int16_t>> recording;
+    std::vector<cppplot::ChannelView<int16_t>> recorded;
+    for (int i = 1; i < argc; i++)
     {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        // glfw::terminate();
-        return -1;
-    }
-
-    glfw::makeContextCurrent(wnd);
-
-    glfw::swapInterval(1);
-
-    std::cout << "GLFW version: " << glfw::getVersionString() << std::endl;
-
-    std::cout << "GLFW version: " << glGetString(GL_VERSION) << std::endl;
-    if (glewInit() != GLEW_OK)
-    {
-        throw std::runtime_error("Could not initialize GLEW");
-    }
-
-    const std::string vertexShaderSource = R"(
-        #version 330 core
-        layout (location = 1) in vec2 aPos;
-        layout (location = 2) in vec3 aColor;
-
-        uniform float uShift;
-        out vec3 vColor;
-        
-        void main()
+        const std::string arg = argv[i];
+        if (arg == "--thick")
         {
-            vColor = aColor;
-            vec2 shiftedPosition = aPos - vec2(uShift, 0);
-            gl_Position = vec4(shiftedPosition, 0, 1);
-            vColor = aColor/ vec3(255.0, 255.0, 255.0);
+            lineWidth = i + 1 < argc && std::atof(argv[i + 1]) > 0 ? std::atof(argv[i + 1]) : 2.0f;
         }
-    )";
-
-    const std::string fragmentShaderSource = R"(
-        #version 330 core
-        in vec3 vColor;
-        out vec4 FragColor;
-        void main()
+        else if (arg == "--file" && i + 2 < argc)
         {
-            FragColor = vec4(vColor, 0.7);
+            try
+            {
+                recording = std::make_unique<cppplot::SampleFile<int16_t>>(argv[i + 1], std::max(1, std::atoi(argv[i + 2])));
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << e.what() << std::endl;
+                return 1;
+            }
+            if (recording->frames() == 0)
+            {
+                std::cerr << "No samples in " << argv[i + 1] << std::endl;
+                return 1;
+            }
+            for (size_t c = 0; c < std::min<size_t>(lineNum, recording->channels()); c++)
+            {
+                recorded.push_back(recording->channel(c));
+            }
+            recording->advise(0, recording->frames(), cppplot::Access::Sequential);
+            i += 2;
         }
-    )";
-
-    const auto vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    const GLchar *vertexShaderSourcePtr = vertexShaderSource.c_str();
-    glShaderSource(vertexShader, 1, &vertexShaderSourcePtr, nullptr);
-    glCompileShader(vertexShader);
-
-    GLint success;
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        GLchar infoLog[512];
-        glGetShaderInfoLog(vertexShader, sizeof(infoLog), nullptr, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-                  << infoLog << std::endl;
     }
 
-    const auto fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    const GLchar *fragmentShaderSourcePtr = fragmentShaderSource.c_str();
-    glShaderSource(fragmentShader, 1, &fragmentShaderSourcePtr, nullptr);
-    glCompileShader(fragmentShader);
+    glEnable(GL_DEBUG_OUTPUT);
+
+    GLenum error = glGetError();
 
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
+    if (canvas.window())
     {
-        GLchar infoLog[512];
-        glGetShaderInfoLog(fragmentShader, sizeof(infoLog), nullptr, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-                  << infoLog << std::endl;
+        std::cout << "GLFW version: " << glfw::getVersionString() << std::endl;
     }
 
-    const auto shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
+    std::cout << "GL version: " << glGetString(GL_VERSION) << std::endl;
 
-    // Check for link errors
-    int success2;
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success2);
-    if (!success2)
-    {
-        char infoLog[512];
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::PROGRAM::LINKING_FAILED\n"
-                  << infoLog << std::endl;
-    }
+    // programs are shared between plots and loaded from shader_cache/ after the first run
+    cppplot::ShaderManager shaders;
+    const auto shaderStart = std::chrono::steady_clock::now();
+    const cppplot::ShaderVariant<cppplot::TimeShift, cppplot::SeriesColor> rollShader(shaders);
+    const cppplot::ShaderVariant<cppplot::TimeShift, cppplot::PickId> pickShader(shaders);
+    const cppplot::ShaderVariant<cppplot::TimeShift, cppplot::ThickLines, cppplot::SeriesColor> thickShader(shaders);
+    const cppplot::ShaderVariant<cppplot::TimeShift, cppplot::ThickLines, cppplot::PickId> thickPickShader(shaders);
+    std::cout << "Shader setup: "
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - shaderStart).count()
+              << " ms (" << (shaders.loaded() ? "binary cache" : "compiled") << ")" << std::endl;
 
     [[maybe_unused]] const auto VAO = []()
     {
@@ -260,23 +225,33 @@ int main()
 
     glBindBuffer(GL_ARRAY_BUFFER, CBO);
     glBufferData(GL_ARRAY_BUFFER, colors.size() * sizeof(char), colors.data(), GL_STATIC_DRAW);
-    auto colorAttribute = glGetAttribLocation(shaderProgram, "aColor");
-    glEnableVertexAttribArray(colorAttribute);
-    glVertexAttribPointer(colorAttribute, 3, GL_UNSIGNED_BYTE, GL_FALSE, 0, (void *)0);
 
     // Position
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-    auto positionAttribute = glGetAttribLocation(shaderProgram, "aPos");
-    glEnableVertexAttribArray(positionAttribute);
-    glVertexAttribPointer(positionAttribute, 2, GL_FLOAT, GL_FALSE, 0, (void *)0);
-
-    // uniforms
-    GLint shiftUniform = glGetUniformLocation(shaderProgram, "uShift");
+    if (lineWidth > 0.0f)
+    {
+        thickShader.setupAttributes(VBO, CBO);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+    else
+    {
+        rollShader.setupAttributes(VBO, CBO);
+    }
 
     // setup
 
-    glUseProgram(shaderProgram);
+    const auto useRollShader = [&]()
+    {
+        lineWidth > 0.0f ? thickShader.use() : rollShader.use();
+    };
+    const auto usePickShader = [&]()
+    {
+        lineWidth > 0.0f ? thickPickShader.use() : pickShader.use();
+    };
+
+    useRollShader();
 
     const auto bufferSize = vertices.size() * sizeof(float);
     std::cout << "Buffer size: " << bufferSize << std::endl;
@@ -291,7 +266,40 @@ int main()
         error = glGetError();
     }
 
-    glfwSetWindowSizeCallback(wnd, onResize);
+    cppplot::GpuTimer gpuTimer(profiler);
+    const auto drawPass = gpuTimer.addPass("roll", "lines");
+    const auto pickPass = gpuTimer.addPass("roll", "pick");
+
+    // the line and buffer slot under the cursor are shown in the title bar
+    std::unique_ptr<cppplot::IdPicker> picker;
+
+    if (auto *wnd = canvas.window())
+    {
+        glfwSetWindowSizeCallback(*wnd, onResize);
+        const auto [width, height] = wnd->getFramebufferSize();
+        picker = std::make_unique<cppplot::IdPicker>(width, height);
+
+        // press P to dump the recorded frame timings, T to start/stop a Chrome trace
+        wnd->keyEvent.setCallback([](glfw::Window &, glfw::KeyCode key, int, glfw::KeyState state, glfw::ModifierKeyBit)
+                                 {
+                                     if (key == glfw::KeyCode::P && state == glfw::KeyState::Press)
+                                     {
+                                         profiler.dumpCsv("roll_profile.csv");
+                                     }
+                                     if (key == glfw::KeyCode::T && state == glfw::KeyState::Press)
+                                     {
+                                         auto &trace = cppplot::TraceWriter::instance();
+                                         if (trace.enabled())
+                                         {
+                                             trace.stop();
+                                         }
+                                         else
+                                         {
+                                             trace.start("roll_trace.json");
+                                         }
+                                     }
+                                 });
+    }
 
     initVertices(vertices);
 
@@ -307,43 +315,114 @@ int main()
     const int bfSize = rollBufferSize + 2;
 
     std::vector<float> ys(lineNum);
+    size_t replayed = 0;
 
-    while (!wnd.shouldClose())
+    // the thick variant matching the program in use draws the same ranges
+    const auto drawLines = [&](const auto &thick)
     {
-        auto start = timer.now();
-
-        // double time = glfw::getTime();
-        glClear(GL_COLOR_BUFFER_BIT);
-
-        for (size_t i = 0; i < lineNum; i++)
+        if (lineWidth > 0.0f)
         {
-            const float a = ys[i] + 0.01 * (i + 1) / lineNum;
-            ys[i] = a - std::lroundf(a);
+            const auto [width, height] = canvas.getSize();
+            thick.setLineWidth(lineWidth, width, height);
+            for (int i = 0; i < lineNum; i++)
+            {
+                thick.draw(i * bfSize, rollData.dataIndex);
+                thick.draw(i * bfSize + rollData.dataIndex, rollBufferSize - rollData.dataIndex);
+                thick.draw(i * bfSize + rollBufferSize, 2);
+            }
+            return;
         }
-
-        updateVertices(ys, rollData, shiftUniform);
-
         for (size_t i = 0; i < lineNum; i++)
         {
             glDrawArrays(GL_LINE_STRIP, i * bfSize, rollData.dataIndex);
             glDrawArrays(GL_LINE_STRIP, i * bfSize + rollData.dataIndex, rollBufferSize - rollData.dataIndex);
             glDrawArrays(GL_LINE_STRIP, i * bfSize + rollBufferSize, 2);
         }
+    };
+
+    while (!canvas.shouldClose())
+    {
+        profiler.beginFrame();
+        gpuTimer.beginFrame();
 
-        glfw::pollEvents();
-        wnd.swapBuffers();
+        // double time = canvas.time();
+        glClear(GL_COLOR_BUFFER_BIT);
 
-        auto end = timer.now();
+        {
+            const auto stage = profiler.scope(cppplot::Stage::DataUpdate);
+            if (recording)
+            {
+                // int16 scaled to the [-0.5, 0.5] of the synthetic lines, looping at the end
+                const size_t frame = replayed++ % recording->frames();
+                for (size_t i = 0; i < recorded.size(); i++)
+                {
+                    ys[i] = recorded[i][frame] / 65536.0f;
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < lineNum; i++)
+                {
+                    const float a = ys[i] + 0.01 * (i + 1) / lineNum;
+                    ys[i] = a - std::lroundf(a);
+                }
+            }
+        }
+        {
+            const auto stage = profiler.scope(cppplot::Stage::Upload);
+            updateVertices(ys, rollData);
+            // the lines move under a still cursor, picked again at the picker's refresh rate
+            if (picker)
+            {
+                picker->dataChanged();
+            }
+            lineWidth > 0.0f ? thickShader.setShift(rollData.shift) : rollShader.setShift(rollData.shift);
+        }
+        {
+            const auto stage = profiler.scope(cppplot::Stage::Draw);
+            const auto gpu = gpuTimer.scope(drawPass);
+            drawLines(thickShader);
+            CPPPLOT_TRACE_COUNTER("vertices drawn", lineNum * (rollBufferSize + 2));
+        }
+        if (picker && picker->begin(*canvas.window()))
+        {
+            const auto stage = profiler.scope(cppplot::Stage::Draw);
+            const auto gpu = gpuTimer.scope(pickPass);
+            usePickShader();
+            lineWidth > 0.0f ? thickPickShader.setShift(rollData.shift) : pickShader.setShift(rollData.shift);
+            drawLines(thickPickShader);
+            picker->end();
+            useRollShader();
+        }
+        if (picker && picker->poll())
+        {
+            const auto &hit = picker->result();
+            const std::string title = hit ? "Line Example - line " + std::to_string(hit->index / bfSize) + ", slot " +
+                                                std::to_string(hit->index % bfSize)
+                                          : "Line Example";
+            canvas.window()->setTitle(title.c_str());
+        }
 
-        elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+        {
+            const auto stage = profiler.scope(cppplot::Stage::PollEvents);
+            canvas.pollEvents();
+        }
+        {
+            const auto stage = profiler.scope(cppplot::Stage::Swap);
+            canvas.present();
+        }
 
-        fps++;
+        profiler.endFrame();
 
-        if (elapsed.count() > 1e9)
+        if (profiler.reportDue())
         {
-            std::cout << "FPS: " << fps << std::endl;
-            elapsed = std::chrono::nanoseconds(0);
-            fps = 0;
+            profiler.print(std::cout);
         }
     }
-}
\ No newline at end of file
+
+    if (canvas.backend() == cppplot::Backend::Offscreen)
+    {
+        const auto [width, height] = canvas.getSize();
+        cppplot::writePpm("roll.ppm", width, height, canvas.readPixels());
+    }
+}
@@ -1,10 +1,23 @@
 #include <GL/glew.h>
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cppplot/axis_transform.h>
+#include <cppplot/canvas.h>
+#include <cppplot/colormap.h>
+#include <cppplot/gpu_timer.h>
+#include <cppplot/id_picking.h>
+#include <cppplot/profiler.h>
+#include <cppplot/resource_pool.h>
+#include <cppplot/spatial_index.h>
+#include <cppplot/synth.h>
+#include <cppplot/view_controller.h>
 #include <glfwpp/glfwpp.h>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
-#include <chrono>
 
 const float squareSize = 0.001f;
 const int maxSquareNum = 30000000;
@@ -12,13 +25,15 @@ const int newDataNum = 1000;
 
 std::vector<float> squarePositions(maxSquareNum * 2);
 const std::vector<char> squareIndices = {0, 1, 2, 2, 1, 3};
-std::vector<char> colors(maxSquareNum * 3);
+// one colormap value per point instead of 3 RGB bytes
+std::vector<uint8_t> colors(maxSquareNum);
 
 int headIndex = 0;
 
-std::chrono::high_resolution_clock timer;
-std::chrono::nanoseconds elapsed(0);
-int fps = 0;
+cppplot::FrameProfiler profiler;
+
+// new positions come from stream 0, continuing where the previous frame stopped, colour values from stream 1
+const cppplot::Synth synth(1);
 
 void initPos(std::vector<float> &pos)
 {
@@ -29,12 +44,9 @@ void initPos(std::vector<float> &pos)
     }
 }
 
-void initColors(std::vector<char> &colors)
+void initColors(std::vector<uint8_t> &colors)
 {
-    for (size_t i = 0; i < colors.size(); i++)
-    {
-        colors[i] = std::rand() % 255;
-    }
+    synth.bytes(colors.data(), colors.size(), 0, 255, 1);
 }
 
 void onResize([[maybe_unused]] GLFWwindow *window, int width, int height)
@@ -42,120 +54,36 @@ void onResize([[maybe_unused]] GLFWwindow *window, int width, int height)
     glViewport(0, 0, width, height);
 }
 
-int main()
+int main(int argc, char **argv)
 {
 
     std::cout << "Hello, GLFWPP!" << std::endl;
 
-    glfw::GlfwLibrary library = glfw::init();
-
-    glfw::WindowHints hints;
-    hints.clientApi = glfw::ClientApi::OpenGl;
-    hints.contextVersionMajor = 4;
-    hints.contextVersionMinor = 6;
-    hints.apply();
-
-    glfw::Window wnd(1200, 800, "Scatter Plot");
+    // --headless [frames] renders offscreen, without a display
+    int frameLimit = 0;
+    const auto backend = cppplot::backendFromArgs(argc, argv, frameLimit);
+    cppplot::Canvas canvas(1200, 800, "Scatter Plot", backend, frameLimit);
 
     glEnable(GL_DEBUG_OUTPUT);
 
     GLenum error = glGetError();
 
-    if (wnd == nullptr)
+    if (canvas.window())
     {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        // glfw::terminate();
-        return -1;
+        std::cout << "GLFW version: " << glfw::getVersionString() << std::endl;
     }
 
-    glfw::makeContextCurrent(wnd);
-
-    glfw::swapInterval(1);
-
-    std::cout << "GLFW version: " << glfw::getVersionString() << std::endl;
+    std::cout << "GL version: " << glGetString(GL_VERSION) << std::endl;
 
-    std::cout << "GLFW version: " << glGetString(GL_VERSION) << std::endl;
-    if (glewInit() != GLEW_OK)
-    {
-        throw std::runtime_error("Could not initialize GLEW");
-    }
-
-    const std::string vertexShaderSource = R"(
-        #version 330 core
-        layout (location = 1) in vec2 aPos;
-        layout (location = 2) in vec3 aColor;
-
-        uniform float uSize;
-        uniform vec2 uOffset;
-        uniform mat2 uScale;
-
-        out vec3 vColor;
-        
-        void main()
-        {
-            vec2 squareVertices[4] = vec2[4](vec2(-1.0, 1.0), vec2(1.0, 1.0), vec2(-1.0, -1.0), vec2(1.0, -1.0));
-            vec2 pos = uSize * squareVertices[gl_VertexID] + aPos;
-            gl_Position = vec4((uScale * pos) + uOffset, 0.0, 1.0);
-
-            vColor = aColor;
-            vColor = aColor/ vec3(255.0, 255.0, 255.0);
-        }
-    )";
-
-    const std::string fragmentShaderSource = R"(
-        #version 330 core
-        in vec3 vColor;
-        out vec4 FragColor;
-        void main()
-        {
-            FragColor = vec4(vColor, 0.7);
-        }
-    )";
-
-    const auto vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    const GLchar *vertexShaderSourcePtr = vertexShaderSource.c_str();
-    glShaderSource(vertexShader, 1, &vertexShaderSourcePtr, nullptr);
-    glCompileShader(vertexShader);
-
-    GLint success;
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        GLchar infoLog[512];
-        glGetShaderInfoLog(vertexShader, sizeof(infoLog), nullptr, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-                  << infoLog << std::endl;
-    }
-
-    const auto fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    const GLchar *fragmentShaderSourcePtr = fragmentShaderSource.c_str();
-    glShaderSource(fragmentShader, 1, &fragmentShaderSourcePtr, nullptr);
-    glCompileShader(fragmentShader);
-
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        GLchar infoLog[512];
-        glGetShaderInfoLog(fragmentShader, sizeof(infoLog), nullptr, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-                  << infoLog << std::endl;
-    }
-
-    const auto shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-
-    // Check for link errors
-    int success2;
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success2);
-    if (!success2)
-    {
-        char infoLog[512];
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::PROGRAM::LINKING_FAILED\n"
-                  << infoLog << std::endl;
-    }
+    // programs are shared between plots and loaded from shader_cache/ after the first run, the pool also
+    // holds the colormap textures
+    cppplot::ResourcePool pool;
+    const auto shaderStart = std::chrono::steady_clock::now();
+    const cppplot::ShaderVariant<cppplot::PointShape<cppplot::Shape::Square>, cppplot::AxisTransforms, cppplot::ScalarColor<uint8_t>> scatterShader(pool.shaders());
+    const cppplot::ShaderVariant<cppplot::PointShape<cppplot::Shape::Square>, cppplot::AxisTransforms, cppplot::PickId> pickShader(pool.shaders());
+    std::cout << "Shader setup: "
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - shaderStart).count()
+              << " ms (" << (pool.shaders().loaded() ? "binary cache" : "compiled") << ")" << std::endl;
 
     [[maybe_unused]] const auto VAO = []()
     {
@@ -189,7 +117,7 @@ int main()
         return CBO;
     }();
 
-    glUseProgram(shaderProgram);
+    scatterShader.use();
 
     // setup elements buffer object
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
@@ -199,34 +127,37 @@ int main()
     initPos(squarePositions);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, squarePositions.size() * sizeof(float), squarePositions.data(), GL_DYNAMIC_DRAW);
-    auto positionAttribute = glGetAttribLocation(shaderProgram, "aPos");
-    glVertexAttribPointer(positionAttribute, 2, GL_FLOAT, GL_FALSE, 0, (void *)0);
-    glVertexAttribDivisor(positionAttribute, 1);
-    glEnableVertexAttribArray(positionAttribute);
 
     // Colors
     initColors(colors);
     glBindBuffer(GL_ARRAY_BUFFER, CBO);
-    glBufferData(GL_ARRAY_BUFFER, colors.size() * sizeof(char), colors.data(), GL_DYNAMIC_DRAW);
-    auto colorAttribute = glGetAttribLocation(shaderProgram, "aColor");
-    glVertexAttribPointer(colorAttribute, 3, GL_UNSIGNED_BYTE, GL_FALSE, 0, (void *)0);
-    glVertexAttribDivisor(colorAttribute, 1);
-    glEnableVertexAttribArray(colorAttribute);
+    glBufferData(GL_ARRAY_BUFFER, colors.size() * sizeof(uint8_t), colors.data(), GL_STATIC_DRAW);
+    scatterShader.setupAttributes(VBO, CBO);
+    std::cout << "Color values: " << colors.size() * sizeof(uint8_t) / (1024 * 1024) << " MB" << std::endl;
 
-    // Uniforms
+    // recolouring only switches the texture or the range uniform
+    auto colormap = cppplot::Colormap::Viridis;
+    bool narrowColorRange = false;
+    bool recolor = true;
 
-    const auto uSize = glGetUniformLocation(shaderProgram, "uSize");
-    const auto uOffset = glGetUniformLocation(shaderProgram, "uOffset");
-    const auto uScale = glGetUniformLocation(shaderProgram, "uScale");
-
-    glUniform1f(uSize, squareSize);
-    glUniform2f(uOffset, 0.0f, 0.0f);
+    // Uniforms
 
-    const auto wndSize = wnd.getSize();
+    const auto wndSize = canvas.getSize();
     std::cout << "Scale: " << std::get<0>(wndSize) << ", " << std::get<1>(wndSize) << std::endl;
     const float aspectRatio = (float)std::get<1>(wndSize) / (float)std::get<0>(wndSize);
     std::cout << "Aspect ratio: " << aspectRatio << std::endl;
-    glUniformMatrix2fv(uScale, 1, GL_FALSE, new float[4]{aspectRatio, 0.0f, 0.0f, 1.0f});
+    pickShader.use();
+    pickShader.setSize(squareSize, aspectRatio);
+    scatterShader.use();
+    scatterShader.setSize(squareSize, aspectRatio);
+
+    // positions stay in data units, the axes map them to the window in the vertex shader and pan/zoom
+    // only changes the axes
+    cppplot::Axis xAxis;
+    xAxis.domainMin = -1 / aspectRatio;
+    xAxis.domainMax = 1 / aspectRatio;
+    cppplot::ViewController view(xAxis, cppplot::Axis());
+    view.trackLatency(profiler);
 
     std::cout << "Here!" << std::endl;
 
@@ -238,51 +169,208 @@ int main()
         error = glGetError();
     }
 
-    glfwSetWindowSizeCallback(wnd, onResize);
+    cppplot::GpuTimer gpuTimer(profiler);
+    const auto drawPass = gpuTimer.addPass("scatter", "points");
+    const auto pickPass = gpuTimer.addPass("scatter", "pick");
+
+    // hover picking needs a cursor, the index and ID buffer are only kept with a window. The CPU index is
+    // used by default, G switches to rendering point IDs on the GPU.
+    std::unique_ptr<cppplot::SpatialIndex> pickIndex;
+    std::unique_ptr<cppplot::IdPicker> picker;
+    bool gpuPicking = false;
+    std::optional<uint32_t> hovered;
+
+    if (auto *wnd = canvas.window())
+    {
+        glfwSetWindowSizeCallback(*wnd, onResize);
+        view.attach(*wnd);
+        pickIndex = std::make_unique<cppplot::SpatialIndex>(maxSquareNum, xAxis.domainMin, xAxis.domainMax, -1.0f, 1.0f);
+        const auto [width, height] = wnd->getFramebufferSize();
+        picker = std::make_unique<cppplot::IdPicker>(width, height);
+
+        // drag to pan, scroll to zoom, middle click to reset; press P to dump the recorded frame timings,
+        // T to start/stop a Chrome trace, L to switch the axes between linear and symlog, G to switch between
+        // CPU and GPU picking, C to cycle the colormap, V to map only the middle half of the values onto it
+        wnd->keyEvent.setCallback([&](glfw::Window &, glfw::KeyCode key, int, glfw::KeyState state, glfw::ModifierKeyBit)
+                                 {
+                                     if (key == glfw::KeyCode::C && state == glfw::KeyState::Press)
+                                     {
+                                         colormap = static_cast<cppplot::Colormap>((static_cast<int>(colormap) + 1) % static_cast<int>(cppplot::Colormap::Count));
+                                         recolor = true;
+                                         std::cout << cppplot::colormapName(colormap) << std::endl;
+                                     }
+                                     if (key == glfw::KeyCode::V && state == glfw::KeyState::Press)
+                                     {
+                                         narrowColorRange = !narrowColorRange;
+                                         recolor = true;
+                                     }
+                                     if (key == glfw::KeyCode::G && state == glfw::KeyState::Press)
+                                     {
+                                         gpuPicking = !gpuPicking;
+                                         picker->invalidate();
+                                         std::cout << (gpuPicking ? "GPU" : "CPU") << " picking" << std::endl;
+                                     }
+                                     if (key == glfw::KeyCode::L && state == glfw::KeyState::Press)
+                                     {
+                                         const auto scale = view.x().scale == cppplot::AxisScale::Linear ? cppplot::AxisScale::Symlog : cppplot::AxisScale::Linear;
+                                         view.x().scale = scale;
+                                         view.y().scale = scale;
+                                         view.x().linearThreshold = 0.05f;
+                                         view.y().linearThreshold = 0.05f;
+                                         view.invalidate();
+                                     }
+                                     if (key == glfw::KeyCode::P && state == glfw::KeyState::Press)
+                                     {
+                                         profiler.dumpCsv("scatter_profile.csv");
+                                     }
+                                     if (key == glfw::KeyCode::T && state == glfw::KeyState::Press)
+                                     {
+                                         auto &trace = cppplot::TraceWriter::instance();
+                                         if (trace.enabled())
+                                         {
+                                             trace.stop();
+                                         }
+                                         else
+                                         {
+                                             trace.start("scatter_trace.json");
+                                         }
+                                     }
+                                 });
+    }
 
     glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 
-    while (!wnd.shouldClose())
+    uint64_t generated = 0;
+    while (!canvas.shouldClose())
     {
-        auto start = timer.now();
+        profiler.beginFrame();
+        gpuTimer.beginFrame();
 
-        float time = glfw::getTime();
+        float time = canvas.time();
         glClear(GL_COLOR_BUFFER_BIT);
 
         // std::vector<float> pos = {(1 / aspectRatio) * (2 * std::rand() / (float)RAND_MAX - 1), 2 * std::rand() / (float)RAND_MAX - 1};
 
         std::vector<float> pos(newDataNum * 2);
 
-        for (size_t i = 0; i < pos.size(); i += 2)
         {
-            pos[i] = (1 / aspectRatio) * (2 * std::rand() / (float)RAND_MAX - 1);
-            pos[i + 1] = 2 * std::rand() / (float)RAND_MAX - 1;
+            const auto stage = profiler.scope(cppplot::Stage::DataUpdate);
+            synth.uniformXy(pos.data(), newDataNum, -1 / aspectRatio, 1 / aspectRatio, -1, 1, 0, generated);
+            generated += newDataNum;
+        }
+        {
+            const auto stage = profiler.scope(cppplot::Stage::Upload);
+            glBindBuffer(GL_ARRAY_BUFFER, VBO);
+            glBufferSubData(GL_ARRAY_BUFFER, headIndex * 2 * sizeof(float), pos.size() * sizeof(float), pos.data());
+            CPPPLOT_TRACE_COUNTER("bytes uploaded", pos.size() * sizeof(float));
+        }
+        if (pickIndex)
+        {
+            const auto stage = profiler.scope(cppplot::Stage::DataUpdate);
+            pickIndex->push(pos.data(), pos.size() / 2);
+        }
+        // new points replace the oldest under a still cursor, picked again at the picker's refresh rate
+        if (picker)
+        {
+            picker->dataChanged();
         }
-
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, headIndex * 2 * sizeof(float), pos.size() * sizeof(float), pos.data());
-        glEnableVertexAttribArray(positionAttribute);
 
         headIndex = (headIndex + pos.size() / 2) % maxSquareNum;
 
         // std::cout << "Head index: " << headIndex << " " << pos[0] << ", " << pos[1] << std::endl;
 
-        glDrawElementsInstanced(GL_TRIANGLES, squareIndices.size(), GL_UNSIGNED_BYTE, 0, maxSquareNum);
-
-        glfw::pollEvents();
-        wnd.swapBuffers();
-
-        auto end = timer.now();
+        {
+            const auto stage = profiler.scope(cppplot::Stage::Draw);
+            const auto gpu = gpuTimer.scope(drawPass);
+            if (view.update())
+            {
+                pickShader.use();
+                pickShader.setAxes(view.x(), view.y());
+                scatterShader.use();
+                scatterShader.setAxes(view.x(), view.y());
+                if (picker)
+                {
+                    picker->invalidate();
+                }
+            }
+            if (recolor)
+            {
+                scatterShader.setColormap(cppplot::colormapTexture(pool, colormap));
+                narrowColorRange ? scatterShader.setColorRange(64, 191) : scatterShader.setColorRange(0, 255);
+                recolor = false;
+            }
+            glDrawElementsInstanced(GL_TRIANGLES, squareIndices.size(), GL_UNSIGNED_BYTE, 0, maxSquareNum);
+            CPPPLOT_TRACE_COUNTER("points drawn", maxSquareNum);
+        }
+        if (gpuPicking && picker->begin(*canvas.window()))
+        {
+            const auto stage = profiler.scope(cppplot::Stage::Draw);
+            const auto gpu = gpuTimer.scope(pickPass);
+            pickShader.use();
+            glDrawElementsInstanced(GL_TRIANGLES, squareIndices.size(), GL_UNSIGNED_BYTE, 0, maxSquareNum);
+            picker->end();
+            scatterShader.use();
+        }
 
-        elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+        {
+            const auto stage = profiler.scope(cppplot::Stage::PollEvents);
+            canvas.pollEvents();
+        }
+        if (gpuPicking)
+        {
+            if (picker->poll())
+            {
+                const auto &hit = picker->result();
+                hovered = hit ? std::optional<uint32_t>(hit->index) : std::nullopt;
+                const std::string title = hit ? "Scatter Plot - point " + std::to_string(hit->index) : "Scatter Plot";
+                canvas.window()->setTitle(title.c_str());
+            }
+        }
+        else if (auto *wnd = canvas.window())
+        {
+            // nearest point within 3 pixels of the cursor, shown in the title bar
+            const auto [cursorX, cursorY] = wnd->getCursorPos();
+            const auto [width, height] = wnd->getSize();
+            const float clipX = 2.0f * cursorX / width - 1.0f;
+            const float clipY = 1.0f - 2.0f * cursorY / height;
+            const float x = view.x().fromClip(clipX);
+            const float y = view.y().fromClip(clipY);
+            const float radius = std::max(std::fabs(view.x().fromClip(clipX + 6.0f / width) - x),
+                                          std::fabs(view.y().fromClip(clipY + 6.0f / height) - y));
+            const auto hit = pickIndex->pick(x, y, radius);
+            const std::optional<uint32_t> index = hit ? std::optional<uint32_t>(hit->index) : std::nullopt;
+            if (index != hovered)
+            {
+                hovered = index;
+                const std::string title = hit ? "Scatter Plot - point " + std::to_string(hit->index) + " (" +
+                                                    std::to_string(hit->x) + ", " + std::to_string(hit->y) + ")"
+                                              : "Scatter Plot";
+                wnd->setTitle(title.c_str());
+            }
+        }
+        {
+            const auto stage = profiler.scope(cppplot::Stage::Swap);
+            canvas.present();
+        }
+        view.presented();
 
-        fps++;
+        profiler.endFrame();
 
-        if (elapsed.count() > 1e9)
+        if (profiler.reportDue())
         {
-            std::cout << "FPS: " << fps << std::endl;
-            elapsed = std::chrono::nanoseconds(0);
-            fps = 0;
+            profiler.print(std::cout);
+            const auto latency = view.latencyStats();
+            if (latency.samples > 0)
+            {
+                std::cout << "  input to photon  p50 " << latency.p50 << " p95 " << latency.p95 << " max " << latency.max
+                          << " ms over " << latency.samples << " view changes" << std::endl;
+            }
         }
     }
-}
\ No newline at end of file
+
+    if (canvas.backend() == cppplot::Backend::Offscreen)
+    {
+        const auto [width, height] = canvas.getSize();
+        cppplot::writePpm("scatter.ppm", width, height, canvas.readPixels());
+    }
+}
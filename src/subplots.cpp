@@ -0,0 +1,197 @@
+#include <GL/glew.h>
+#include <algorithm>
+#include <cmath>
+#include <cppplot/canvas.h>
+#include <cppplot/gpu_timer.h>
+#include <cppplot/profiler.h>
+#include <cppplot/subplots.h>
+#include <cppplot/synth.h>
+#include <cstdlib>
+#include <glfwpp/glfwpp.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Grid of scrolling channel plots in one window, 16 x 16 by default. All subplots draw in a single
+// glMultiDrawArrays call, each vertex finding its subplot transform in a uniform buffer;
+// --per-subplot issues one glDrawArrays per channel instead, for comparison.
+//
+//   subplots [--grid ROWS COLS] [--per-subplot] [--headless [frames]]
+
+const int channelSize = 2000;
+
+using ChannelShader = cppplot::ShaderVariant<cppplot::TimeShift, cppplot::SeriesColor, cppplot::Subplots>;
+
+cppplot::FrameProfiler profiler;
+
+// Every channel spans two plot widths so it can scroll by one width and wrap
+void initVertices(std::vector<float> &vertices, int channels)
+{
+    for (int i = 0; i < channels; i++)
+    {
+        const float frequency = 1.0f + (i % 7);
+        for (int j = 0; j < channelSize; j++)
+        {
+            const float x = -1.0f + 4.0f * j / (channelSize - 1);
+            vertices[(i * channelSize + j) * 2] = x;
+            vertices[(i * channelSize + j) * 2 + 1] = 0.8f * std::sin(x * 3.14159f * frequency + i) * std::cos(x * 0.7f * frequency);
+        }
+    }
+}
+
+void initColors(std::vector<uint8_t> &colors, int channels)
+{
+    // one colour per line, the same on every run
+    std::vector<uint8_t> rgb(channels * 3);
+    cppplot::Synth(1).bytes(rgb.data(), rgb.size(), 80, 255);
+    for (int i = 0; i < channels; i++)
+    {
+        const uint8_t r = rgb[i * 3];
+        const uint8_t g = rgb[i * 3 + 1];
+        const uint8_t b = rgb[i * 3 + 2];
+        for (int j = 0; j < channelSize; j++)
+        {
+            colors[(i * channelSize + j) * 3] = r;
+            colors[(i * channelSize + j) * 3 + 1] = g;
+            colors[(i * channelSize + j) * 3 + 2] = b;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int rows = 16;
+    int cols = 16;
+    bool batched = true;
+    int frameLimit;
+    const auto backend = cppplot::backendFromArgs(argc, argv, frameLimit);
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--grid" && i + 2 < argc)
+        {
+            rows = std::max(1, std::atoi(argv[++i]));
+            cols = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--per-subplot")
+        {
+            batched = false;
+        }
+    }
+
+    cppplot::Canvas canvas(1600, 1000, "Subplots Example", backend, frameLimit);
+    std::cout << "GL version: " << glGetString(GL_VERSION) << std::endl;
+
+    cppplot::ShaderManager shaders;
+    cppplot::SubplotLayout layout(shaders, rows, cols);
+    const int channels = layout.count();
+    std::cout << rows << " x " << cols << " subplots, " << (batched ? "one multi-draw" : "one draw per subplot") << std::endl;
+
+    std::vector<float> vertices(static_cast<size_t>(channels) * channelSize * 2);
+    std::vector<uint8_t> colors(static_cast<size_t>(channels) * channelSize * 3);
+    initVertices(vertices, channels);
+    initColors(colors, channels);
+
+    GLuint VAO;
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+
+    GLuint buffers[2];
+    glGenBuffers(2, buffers);
+    glBindBuffer(GL_ARRAY_BUFFER, buffers[1]);
+    glBufferData(GL_ARRAY_BUFFER, colors.size(), colors.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+
+    const ChannelShader channelShader(shaders);
+    channelShader.setupAttributes(buffers[0], buffers[1]);
+    channelShader.use();
+    channelShader.setLayout(layout.bindingPoint(), channelSize);
+
+    // first vertex and count of every channel for glMultiDrawArrays
+    std::vector<GLint> firsts(channels);
+    std::vector<GLsizei> counts(channels, channelSize);
+    for (int i = 0; i < channels; i++)
+    {
+        firsts[i] = i * channelSize;
+    }
+
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+
+    cppplot::GpuTimer gpuTimer(profiler);
+    const auto drawPass = gpuTimer.addPass("subplots", "lines");
+
+    if (auto *wnd = canvas.window())
+    {
+        // press P to dump the recorded frame timings
+        wnd->keyEvent.setCallback([](glfw::Window &, glfw::KeyCode key, int, glfw::KeyState state, glfw::ModifierKeyBit)
+                                 {
+                                     if (key == glfw::KeyCode::P && state == glfw::KeyState::Press)
+                                     {
+                                         profiler.dumpCsv("subplots_profile.csv");
+                                     } });
+    }
+
+    while (!canvas.shouldClose())
+    {
+        profiler.beginFrame();
+        gpuTimer.beginFrame();
+
+        glClear(GL_COLOR_BUFFER_BIT);
+        {
+            const auto stage = profiler.scope(cppplot::Stage::Draw);
+            const auto gpu = gpuTimer.scope(drawPass);
+
+            layout.drawFrames(0.35f, 0.35f, 0.35f);
+
+            // clip every channel to its subplot, the frames do not write clip distances
+            for (int i = 0; i < 4; i++)
+            {
+                glEnable(GL_CLIP_DISTANCE0 + i);
+            }
+            glBindVertexArray(VAO);
+            channelShader.use();
+            channelShader.setShift(std::fmod(canvas.frames() * 0.004f, 2.0f));
+            if (batched)
+            {
+                glMultiDrawArrays(GL_LINE_STRIP, firsts.data(), counts.data(), channels);
+            }
+            else
+            {
+                for (int i = 0; i < channels; i++)
+                {
+                    glDrawArrays(GL_LINE_STRIP, firsts[i], counts[i]);
+                }
+            }
+            for (int i = 0; i < 4; i++)
+            {
+                glDisable(GL_CLIP_DISTANCE0 + i);
+            }
+            CPPPLOT_TRACE_COUNTER("vertices drawn", channels * channelSize);
+        }
+        {
+            const auto stage = profiler.scope(cppplot::Stage::PollEvents);
+            canvas.pollEvents();
+        }
+        {
+            const auto stage = profiler.scope(cppplot::Stage::Swap);
+            canvas.present();
+        }
+
+        profiler.endFrame();
+
+        if (profiler.reportDue())
+        {
+            profiler.print(std::cout);
+        }
+    }
+
+    if (canvas.backend() == cppplot::Backend::Offscreen)
+    {
+        const auto [width, height] = canvas.getSize();
+        cppplot::writePpm("subplots.ppm", width, height, canvas.readPixels());
+    }
+
+    glDeleteBuffers(2, buffers);
+    glDeleteVertexArrays(1, &VAO);
+}
@@ -0,0 +1,177 @@
+#include <cppplot/scene.h>
+#include <cppplot/soft_raster.h>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef CPPPLOT_TEST_GL
+#include <GL/glew.h>
+#include <cppplot/axis_transform.h>
+#include <cppplot/offscreen.h>
+#include <cppplot/shader.h>
+#endif
+
+// Renders three horizontal lines offscreen and checks the pixels: always with the software rasterizer,
+// on one and on every hardware thread, and, in builds with EGL and GLEW (CPPPLOT_TEST_GL), through the
+// GL pipeline of the demos (ShaderVariant with AxisTransforms and SeriesColor in a Framebuffer). Exits
+// with the number of failed checks.
+
+const int width = 256;
+const int height = 128;
+const float lineY[3] = {-0.5f, 0.0f, 0.5f};
+const uint8_t lineRgb[3][3] = {{255, 0, 0}, {0, 255, 0}, {0, 0, 255}};
+
+int failures = 0;
+
+void check(bool passed, const std::string &what)
+{
+    std::cout << (passed ? "pass  " : "FAIL  ") << what << std::endl;
+    failures += !passed;
+}
+
+// Two vertices per line, across the whole x domain
+struct Lines
+{
+    std::vector<float> xy;
+    std::vector<uint8_t> rgb;
+
+    Lines()
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            xy.insert(xy.end(), {0.0f, lineY[i], 100.0f, lineY[i]});
+            rgb.insert(rgb.end(), lineRgb[i], lineRgb[i] + 3);
+            rgb.insert(rgb.end(), lineRgb[i], lineRgb[i] + 3);
+        }
+    }
+};
+
+cppplot::Axis xAxis()
+{
+    cppplot::Axis x;
+    x.domainMin = 0.0f;
+    x.domainMax = 100.0f;
+    return x;
+}
+
+// Each line must have its colour as the dominant channel in the middle column within a pixel of where it
+// belongs, and the corners must be background
+void checkImage(const std::vector<uint8_t> &rgba, const cppplot::Color &background, const std::string &renderer)
+{
+    check(rgba.size() == static_cast<size_t>(width) * height * 4, renderer + ": image size");
+    if (rgba.size() != static_cast<size_t>(width) * height * 4)
+    {
+        return;
+    }
+    const auto pixel = [&rgba](int x, int y)
+    { return rgba.data() + (static_cast<size_t>(y) * width + x) * 4; };
+
+    for (int i = 0; i < 3; i++)
+    {
+        const int expected = static_cast<int>((1.0f - lineY[i]) * 0.5f * height);
+        bool found = false;
+        for (int y = expected - 2; y <= expected + 1; y++)
+        {
+            const uint8_t *p = pixel(width / 2, y);
+            found = found || (p[i] > 100 && p[i] > p[(i + 1) % 3] + 50 && p[i] > p[(i + 2) % 3] + 50);
+        }
+        check(found, renderer + ": line " + std::to_string(i) + " near row " + std::to_string(expected));
+    }
+
+    bool corners = true;
+    for (const auto &[x, y] : {std::pair{0, 0}, std::pair{width - 1, 0}, std::pair{0, height - 1}, std::pair{width - 1, height - 1}})
+    {
+        const uint8_t *p = pixel(x, y);
+        corners = corners && p[0] == background.r && p[1] == background.g && p[2] == background.b;
+    }
+    check(corners, renderer + ": background");
+}
+
+void testSoftware(const Lines &lines)
+{
+    cppplot::Scene scene;
+    scene.width = width;
+    scene.height = height;
+    scene.x = xAxis();
+    cppplot::Series series;
+    series.xy = lines.xy.data();
+    series.count = lines.xy.size() / 2;
+    series.stripLength = 2;
+    series.rgb = lines.rgb.data();
+    scene.series.push_back(series);
+
+    cppplot::SoftRasterizer single(1);
+    cppplot::SoftRasterizer threaded(4);
+    const auto image = single.render(scene);
+    checkImage(image, scene.background, "software");
+    check(threaded.render(scene) == image, "software: same image on 1 and 4 threads");
+}
+
+#ifdef CPPPLOT_TEST_GL
+void testGl(const Lines &lines)
+{
+    cppplot::OffscreenContext context;
+    glewExperimental = GL_TRUE;
+    const auto status = glewInit();
+    if (status != GLEW_OK && status != GLEW_ERROR_NO_GLX_DISPLAY)
+    {
+        check(false, "gl: GLEW initialization");
+        return;
+    }
+    std::cout << "GL: " << glGetString(GL_RENDERER) << std::endl;
+
+    cppplot::Framebuffer framebuffer(width, height);
+    framebuffer.bind();
+    glViewport(0, 0, width, height);
+    const cppplot::Color background{26, 26, 26};
+    glClearColor(background.r / 255.0f, background.g / 255.0f, background.b / 255.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    // no binary cache, the test must not leave files behind
+    cppplot::ShaderManager shaders("");
+    const cppplot::ShaderVariant<cppplot::AxisTransforms, cppplot::SeriesColor> shader(shaders);
+
+    GLuint vao;
+    GLuint buffers[2];
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glGenBuffers(2, buffers);
+    glBindBuffer(GL_ARRAY_BUFFER, buffers[1]);
+    glBufferData(GL_ARRAY_BUFFER, lines.rgb.size(), lines.rgb.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, lines.xy.size() * sizeof(float), lines.xy.data(), GL_STATIC_DRAW);
+    shader.setupAttributes(buffers[0], buffers[1]);
+    shader.use();
+    shader.setAxes(xAxis(), cppplot::Axis());
+    for (int i = 0; i < 3; i++)
+    {
+        glDrawArrays(GL_LINE_STRIP, i * 2, 2);
+    }
+
+    checkImage(framebuffer.readPixels(), background, "gl");
+    check(glGetError() == GL_NO_ERROR, "gl: no GL error");
+
+    glDeleteBuffers(2, buffers);
+    glDeleteVertexArrays(1, &vao);
+}
+#endif
+
+int main()
+{
+    const Lines lines;
+    testSoftware(lines);
+#ifdef CPPPLOT_TEST_GL
+    try
+    {
+        testGl(lines);
+    }
+    catch (const std::exception &e)
+    {
+        check(false, std::string("gl: ") + e.what());
+    }
+#endif
+    return failures;
+}